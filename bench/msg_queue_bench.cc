@@ -0,0 +1,114 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*!
+ * Messages per second through a block message queue.
+ * Compares the old mutex and std::queue with the lock-free msg_queue,
+ * for 1, 2 and 4 producer threads posting to one consumer thread.
+ */
+
+#include "msg_queue.h"
+#include "perf_ticks.h"
+#include <gr_tags.h>
+#include <boost/bind.hpp>
+#include <queue>
+#include <cstdio>
+
+static const size_t NUM_MSGS = 2000000;
+
+//! The queue that blocks used before, a mutex and a condition per push
+struct mutex_queue
+{
+    void push(const gr_tag_t &msg)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _queue.push(msg);
+        lock.unlock();
+        _cond.notify_one();
+    }
+
+    bool pop(gr_tag_t &msg)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        while (_queue.empty()) _cond.wait(lock);
+        msg = _queue.front();
+        _queue.pop();
+        return true;
+    }
+
+    std::queue<gr_tag_t> _queue;
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+};
+
+template <typename Queue>
+static void producer(Queue *queue, const size_t num)
+{
+    gr_tag_t msg;
+    msg.key = pmt::pmt_string_to_symbol("bench");
+    msg.value = pmt::pmt_from_long(0);
+    msg.srcid = pmt::PMT_F;
+    for (size_t i = 0; i < num; i++)
+    {
+        msg.offset = i;
+        queue->push(msg);
+    }
+}
+
+template <typename Queue>
+static void consumer(Queue *queue, const size_t num)
+{
+    gr_tag_t msg;
+    for (size_t i = 0; i < num; i++) queue->pop(msg);
+}
+
+//! Run the producers and consumer, return messages per second
+template <typename Queue>
+static double run(const size_t num_producers)
+{
+    Queue queue;
+    const size_t per = NUM_MSGS/num_producers;
+    const long long t0 = perf_ticks();
+    boost::thread_group producers;
+    for (size_t i = 0; i < num_producers; i++)
+    {
+        producers.create_thread(boost::bind(&producer<Queue>, &queue, per));
+    }
+    boost::thread cons(boost::bind(&consumer<Queue>, &queue, per*num_producers));
+    producers.join_all();
+    cons.join();
+    const double secs = (perf_ticks() - t0)/perf_ticks_per_sec();
+    return (per*num_producers)/secs;
+}
+
+int main(void)
+{
+    std::printf("%u messages, one consumer, %u processors\n",
+        unsigned(NUM_MSGS), unsigned(boost::thread::hardware_concurrency()));
+    std::printf("producers  mutex+std::queue  lock-free ring\n");
+    for (size_t n = 1; n <= 4; n *= 2)
+    {
+        const double before = run<mutex_queue>(n);
+        const double after = run<gnuradio::msg_queue<gr_tag_t> >(n);
+        std::printf("%-9u  %6.2f Mmsg/s      %6.2f Mmsg/s\n", unsigned(n), before/1e6, after/1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*!
+ * Time per item of the binary op kernels, one row per type.
+ * The reference is the plain loop that the blocks ran before the kernels,
+ * built with the same flags; the complex rows use a correct complex multiply.
+ * Set EXTRAS_SIMD=generic to time the 128-bit kernels instead of AVX2.
+ */
+
+#include "op_kernels.h"
+#include "perf_ticks.h"
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+static const size_t NUM_ITEMS = 4096;
+
+#define EXTRAS_BENCH_LOOP(name, expr) \
+    template <typename T> \
+    static void name(T *out, const T *in0, const T *in1, const size_t n){ \
+        for (size_t i = 0; i < n; i++) out[i] = expr; \
+    }
+
+EXTRAS_BENCH_LOOP(loop_add, in0[i] + in1[i])
+EXTRAS_BENCH_LOOP(loop_subtract, in0[i] - in1[i])
+EXTRAS_BENCH_LOOP(loop_multiply, in0[i] * in1[i])
+
+template <typename T>
+static void loop_multiply(std::complex<T> *out, const std::complex<T> *in0, const std::complex<T> *in1, const size_t n){
+    for (size_t i = 0; i < n; i++) out[i] = std::complex<T>(
+        T(in0[i].real()*in1[i].real() - in0[i].imag()*in1[i].imag()),
+        T(in0[i].real()*in1[i].imag() + in0[i].imag()*in1[i].real())
+    );
+}
+
+//! Nanoseconds per item of one binary function
+template <typename T>
+static double time_per_item(void (*fn)(T *, const T *, const T *, const size_t)){
+    std::vector<T> in0(NUM_ITEMS), in1(NUM_ITEMS), out(NUM_ITEMS);
+    for (size_t i = 0; i < NUM_ITEMS; i++){
+        in0[i] = T(i%7);
+        in1[i] = T(i%5);
+    }
+    const size_t reps = (size_t(1) << 26)/NUM_ITEMS;
+    fn(&out[0], &in0[0], &in1[0], NUM_ITEMS);
+    const long long t0 = perf_ticks();
+    for (size_t r = 0; r < reps; r++) fn(&out[0], &in0[0], &in1[0], NUM_ITEMS);
+    const double secs = (perf_ticks() - t0)/perf_ticks_per_sec();
+    return secs*1e9/(reps*NUM_ITEMS);
+}
+
+template <typename T>
+static void bench_row(
+    const char *label,
+    void (*loop)(T *, const T *, const T *, const size_t),
+    void (*kernel)(T *, const T *, const T *, const size_t)
+){
+    const double before = time_per_item(loop);
+    const double after = time_per_item(kernel);
+    std::printf("%-10s %8.3f %8.3f   x%.1f\n", label, before, after, before/after);
+}
+
+#define EXTRAS_BENCH_ROW(label, op, type) \
+    bench_row<type >(label, &loop_ ## op, &gnuradio::kernels::op)
+
+int main(void)
+{
+    std::printf("%u items per call, ns per item, kernels: %s\n", unsigned(NUM_ITEMS), gnuradio::kernels::simd_name());
+    std::printf("type         loop   kernel\n");
+    EXTRAS_BENCH_ROW("add s8", add, int8_t);
+    EXTRAS_BENCH_ROW("add s16", add, int16_t);
+    EXTRAS_BENCH_ROW("add s32", add, int32_t);
+    EXTRAS_BENCH_ROW("add f32", add, float);
+    EXTRAS_BENCH_ROW("sub s8", subtract, int8_t);
+    EXTRAS_BENCH_ROW("sub s16", subtract, int16_t);
+    EXTRAS_BENCH_ROW("sub s32", subtract, int32_t);
+    EXTRAS_BENCH_ROW("sub f32", subtract, float);
+    EXTRAS_BENCH_ROW("mul s8", multiply, int8_t);
+    EXTRAS_BENCH_ROW("mul s16", multiply, int16_t);
+    EXTRAS_BENCH_ROW("mul s32", multiply, int32_t);
+    EXTRAS_BENCH_ROW("mul f32", multiply, float);
+    EXTRAS_BENCH_ROW("mul sc8", multiply, std::complex<int8_t>);
+    EXTRAS_BENCH_ROW("mul sc16", multiply, std::complex<int16_t>);
+    EXTRAS_BENCH_ROW("mul sc32", multiply, std::complex<int32_t>);
+    EXTRAS_BENCH_ROW("mul fc32", multiply, std::complex<float>);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*!
+ * The const_v blocks multiply by a constant pattern of vlen numbers.
+ * Times three ways to do it, in microseconds per call of 4096 items:
+ *  - stream: the binary kernel over the pattern repeated in memory,
+ *    which is what the periodic kernels fall back to
+ *  - registers: the periodic kernel, the pattern held in registers
+ *  - fixed: a scalar loop specialized at compile time for the vlen
+ */
+
+#include "op_kernels.h"
+#include "perf_ticks.h"
+#include <algorithm>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+static const size_t NUM_ITEMS = 4096;
+static const size_t NUM_REPS = 20000;
+
+template <typename T>
+static void stream_multiply(T *out, const T *in, const T *pattern, const size_t period, const size_t n){
+    const size_t len = gnuradio::kernels::pattern_length(period);
+    for (size_t i = 0; i < n; i += len){
+        gnuradio::kernels::multiply(out + i, in + i, pattern, std::min(len, n - i));
+    }
+}
+
+template <typename T>
+static void register_multiply(T *out, const T *in, const T *pattern, const size_t period, const size_t n){
+    gnuradio::kernels::multiply_periodic(out, in, pattern, period, n);
+}
+
+template <size_t vlen, typename T>
+static void fixed_multiply(T *out, const T *in, const T *pattern, const size_t, const size_t n){
+    T val[vlen];
+    for (size_t j = 0; j < vlen; j++) val[j] = pattern[j];
+    for (size_t i = 0; i < n; i += vlen){
+        for (size_t j = 0; j < vlen; j++) out[i + j] = in[i + j]*val[j];
+    }
+}
+
+//! Best of several runs, microseconds per call
+template <typename T>
+static double time_call(
+    void (*fn)(T *, const T *, const T *, const size_t, const size_t),
+    const std::vector<T> &pattern, const size_t period
+){
+    std::vector<T> in(NUM_ITEMS, T(3)), out(NUM_ITEMS);
+    double best = 1e9;
+    for (size_t run = 0; run < 5; run++){
+        const long long t0 = perf_ticks();
+        for (size_t r = 0; r < NUM_REPS; r++) fn(&out[0], &in[0], &pattern[0], period, NUM_ITEMS);
+        best = std::min(best, (perf_ticks() - t0)/perf_ticks_per_sec()/NUM_REPS*1e6);
+    }
+    return best;
+}
+
+template <size_t vlen, typename T>
+static void bench_row(const char *label){
+    std::vector<T> pattern(gnuradio::kernels::pattern_length(vlen));
+    for (size_t i = 0; i < pattern.size(); i++) pattern[i] = T(i%vlen + 1);
+    std::printf("%-5s vlen %-3u %8.2f %8.2f %8.2f\n", label, unsigned(vlen),
+        time_call<T>(&stream_multiply<T>, pattern, vlen),
+        time_call<T>(&register_multiply<T>, pattern, vlen),
+        time_call<T>(&fixed_multiply<vlen, T>, pattern, vlen)
+    );
+}
+
+int main(void)
+{
+    std::printf("%u items per call, us per call, kernels: %s\n", unsigned(NUM_ITEMS), gnuradio::kernels::simd_name());
+    std::printf("type  vlen      stream registers    fixed\n");
+    bench_row<1, float>("f32");
+    bench_row<2, float>("f32");
+    bench_row<4, float>("f32");
+    bench_row<8, float>("f32");
+    bench_row<16, float>("f32");
+    bench_row<64, float>("f32");
+    bench_row<1, int16_t>("s16");
+    bench_row<4, int16_t>("s16");
+    bench_row<16, int16_t>("s16");
+    bench_row<1, std::complex<float> >("fc32");
+    bench_row<4, std::complex<float> >("fc32");
+    bench_row<1, std::complex<int16_t> >("sc16");
+    bench_row<4, std::complex<int16_t> >("sc16");
+    bench_row<16, std::complex<int16_t> >("sc16");
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*!
+ * Cost of get_tags_in_range() with 10k tags in the work window.
+ * The core is modeled as what it does: a linear scan over every tag.
+ * The index is filled with one scan per call, as the master block does,
+ * and the first four queries of a call still go to the core.
+ */
+
+#include "tag_index.h"
+#include "perf_ticks.h"
+#include <cstdio>
+
+static const size_t NUM_TAGS = 10000;
+static const uint64_t WINDOW = 100000;
+static const size_t NUM_PACKETS = 2500;
+static const size_t NUM_CALLS = 20;
+
+//! The tags in the buffer, as the core keeps them
+static std::deque<gr_tag_t> buffer_tags;
+
+static void core_get_tags(
+    std::vector<gr_tag_t> &tags, const uint64_t start, const uint64_t end, const pmt::pmt_t *key
+){
+    tags.clear();
+    for (std::deque<gr_tag_t>::const_iterator it = buffer_tags.begin(); it != buffer_tags.end(); ++it)
+    {
+        if (it->offset < start || it->offset >= end) continue;
+        if (key != NULL && !pmt::pmt_eqv(it->key, *key)) continue;
+        tags.push_back(*it);
+    }
+}
+
+static void fill_index(gnuradio::tag_index &index, const uint64_t base)
+{
+    std::vector<gr_tag_t> fill;
+    index.prune(base);
+    core_get_tags(fill, index.end(), base + WINDOW, NULL);
+    index.fill(fill, base + WINDOW);
+}
+
+static double secs_since(const long long t0)
+{
+    return (perf_ticks() - t0)/perf_ticks_per_sec();
+}
+
+int main(void)
+{
+    const pmt::pmt_t keys[4] = {
+        pmt::pmt_string_to_symbol("rx_time"), pmt::pmt_string_to_symbol("sob"),
+        pmt::pmt_string_to_symbol("eob"), pmt::pmt_string_to_symbol("pkt_len")
+    };
+    const uint64_t packet = WINDOW/NUM_PACKETS;
+
+    gnuradio::tag_index packet_index;
+    std::vector<gr_tag_t> tags;
+    double core_whole = 0, core_packet = 0, index_packet = 0;
+    size_t found = 0;
+
+    for (size_t call = 0; call < NUM_CALLS; call++)
+    {
+        const uint64_t base = call*WINDOW;
+        buffer_tags.clear();
+        for (size_t i = 0; i < NUM_TAGS; i++)
+        {
+            gr_tag_t tag;
+            tag.offset = base + i*(WINDOW/NUM_TAGS);
+            tag.key = keys[i%4];
+            buffer_tags.push_back(tag);
+        }
+
+        //a few keyed queries over the whole window, under the threshold so never indexed
+        long long t0 = perf_ticks();
+        for (size_t k = 0; k < 3; k++)
+        {
+            core_get_tags(tags, base, base + WINDOW, &keys[k]);
+            found += tags.size();
+        }
+        core_whole += secs_since(t0);
+
+        //one keyed query per packet
+        t0 = perf_ticks();
+        for (size_t p = 0; p < NUM_PACKETS; p++)
+        {
+            core_get_tags(tags, base + p*packet, base + (p + 1)*packet, &keys[0]);
+            found += tags.size();
+        }
+        core_packet += secs_since(t0);
+
+        t0 = perf_ticks();
+        for (size_t p = 0; p < 4; p++)
+        {
+            core_get_tags(tags, base + p*packet, base + (p + 1)*packet, &keys[0]);
+            found += tags.size();
+        }
+        fill_index(packet_index, base);
+        for (size_t p = 4; p < NUM_PACKETS; p++)
+        {
+            tags.clear();
+            packet_index.get(tags, base + p*packet, base + (p + 1)*packet, keys[0]);
+            found += tags.size();
+        }
+        index_packet += secs_since(t0);
+    }
+
+    std::printf("%u tags per %u item window, %u calls (%u tags found)\n",
+        unsigned(NUM_TAGS), unsigned(WINDOW), unsigned(NUM_CALLS), unsigned(found));
+    std::printf("3 keyed whole-window queries: core %.3f ms/call, not indexed\n",
+        core_whole/NUM_CALLS*1e3);
+    std::printf("%u keyed per-packet queries: core %.3f ms/call, indexed %.3f ms/call\n",
+        unsigned(NUM_PACKETS), core_packet/NUM_CALLS*1e3, index_packet/NUM_CALLS*1e3);
+    return 0;
+}
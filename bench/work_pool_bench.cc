@@ -0,0 +1,69 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*!
+ * Time of one large N-ary multiply call, on one thread and split across the work pool.
+ * The pool size follows EXTRAS_WORK_THREADS, as it does in the library,
+ * ex: for t in 0 1 3 7; do EXTRAS_WORK_THREADS=$t ./work_pool_bench; done
+ */
+
+#include "work_pool.h"
+#include "op_kernels.h"
+#include "perf_ticks.h"
+#include <algorithm>
+#include <cstdio>
+
+static void multiply_items(float *out, const float *const *in, const size_t m, const size_t n, const bool){
+    gnuradio::kernels::multiply(out, in, m, n);
+}
+
+//! Best of several runs, microseconds per call
+static double time_call(const size_t m, const size_t n, const bool split){
+    std::vector<std::vector<float> > ins(m, std::vector<float>(n, 1.0001f));
+    std::vector<const float *> in(m), chunk_ins;
+    for (size_t k = 0; k < m; k++) in[k] = &ins[k][0];
+    std::vector<float> out(n);
+    const size_t reps = std::max<size_t>(1, (size_t(1) << 26)/(n*m));
+    double best = 1e9;
+    for (size_t run = 0; run < 5; run++){
+        const long long t0 = perf_ticks();
+        for (size_t r = 0; r < reps; r++){
+            gnuradio::parallel_nary(&multiply_items, &out[0], &in[0], m, n, true, split, chunk_ins);
+        }
+        best = std::min(best, (perf_ticks() - t0)/perf_ticks_per_sec()/reps*1e6);
+    }
+    return best;
+}
+
+int main(void)
+{
+    std::printf("f32 multiply, %u processors, %u pool threads, us per call\n",
+        unsigned(boost::thread::hardware_concurrency()), unsigned(gnuradio::work_pool::shared().num_threads()));
+    std::printf("inputs  numbers     one thread    split\n");
+    const size_t sizes[] = {8192, 65536, 1 << 20};
+    for (size_t m = 2; m <= 8; m *= 2){
+        for (size_t i = 0; i < 3; i++){
+            std::printf("%-7u %-10u %10.1f %10.1f\n", unsigned(m), unsigned(sizes[i]),
+                time_call(m, sizes[i], false), time_call(m, sizes[i], true));
+        }
+    }
+    return 0;
+}
@@ -79,6 +79,26 @@ struct GR_EXTRAS_API msg_signature
     size_t num_outputs;
 };
 
+//! A snapshot of the performance counters of a block
+struct GR_EXTRAS_API block_perf_counters
+{
+    block_perf_counters(void):
+        work_calls(0), work_time_total(0.0), work_time_max(0.0),
+        msg_queue_high_water(0), msgs_posted(0), msgs_popped(0)
+    {
+        //NOP
+    }
+
+    uint64_t work_calls; //!< number of calls into work()
+    double work_time_total; //!< seconds spent in work(), cumulative
+    double work_time_max; //!< seconds spent in the longest call to work()
+    std::vector<uint64_t> items_consumed; //!< items consumed per input port
+    std::vector<uint64_t> items_produced; //!< items produced per output port
+    size_t msg_queue_high_water; //!< max messages that were waiting in one port queue
+    uint64_t msgs_posted; //!< messages posted to all message output ports
+    uint64_t msgs_popped; //!< messages popped from the message queue
+};
+
 /*!
  * The base clock class that provides message passing,
  * and a more object oriented access to work buffers.
@@ -120,6 +140,18 @@ public:
      */
     void set_auto_consume(const bool automatic);
 
+    /*!
+     * Declare that work() is safe when output 0 aliases input 0.
+     * In other words, work reads each input item before it writes
+     * the output item at the same index, as in out[i] = f(in[i]).
+     * The flow graph still gives the block separate buffers,
+     * but an extras::inplace_chain can run it over a shared buffer.
+     * \param inplace true when output 0 may alias input 0
+     */
+    void set_inplace(const bool inplace);
+
+    bool inplace(void) const;
+
     /*******************************************************************
      * Basic routines from basic block
      ******************************************************************/
@@ -136,6 +168,34 @@ public:
 
     int output_multiple(void) const;
 
+    /*!
+     * Set the minimum number of output items per call to work.
+     * Fewer, larger calls trade latency for throughput,
+     * which helps most with the per-call overhead of python blocks.
+     * The minimum is enforced by rounding the output multiple up,
+     * so work is always given a multiple of output_multiple() items.
+     * With automatic consumption, the last call at the end of the stream
+     * is given the remaining items even when that is less than the minimum.
+     * Without it, a tail shorter than the minimum is never given to work.
+     * \param min_noutput the minimum, 0 for no minimum
+     * \throws std::invalid_argument when above the maximum
+     */
+    void set_min_noutput_items(int min_noutput);
+
+    int min_noutput_items(void) const;
+
+    /*!
+     * Set the maximum number of output items per call to work.
+     * Smaller calls keep latency and cache footprint down.
+     * The maximum is rounded down to the output multiple,
+     * but a call is never given less than one output multiple.
+     * \param max_noutput the maximum, 0 for no maximum
+     * \throws std::invalid_argument when below the minimum
+     */
+    void set_max_noutput_items(int max_noutput);
+
+    int max_noutput_items(void) const;
+
     void consume(int which_input, int how_many_items);
 
     void consume_each(int how_many_items);
@@ -145,11 +205,22 @@ public:
     /*!
      * The relative rate can be thought of as interpolation/decimation.
      * In other words, relative rate is the ratio of output items to input items.
+     * Integer and 1/integer rates are set exactly, as with set_rate().
      */
     void set_relative_rate(double relative_rate);
 
     double relative_rate(void) const;
 
+    /*!
+     * Set an exact rational rate of interp output items per decim input items.
+     * With automatic consumption, forecast and consume use integer math,
+     * so rates such as 3/7 neither drift nor over-request input.
+     * The output multiple is raised to a multiple of the reduced interp.
+     * \param interp the interpolation, a positive integer
+     * \param decim the decimation, a positive integer
+     */
+    void set_rate(const int interp, const int decim);
+
     /*******************************************************************
      * Tag related routines from basic block
      ******************************************************************/
@@ -174,6 +245,12 @@ public:
         const pmt::pmt_t &srcid=pmt::PMT_F
     );
 
+    /*!
+     * Get the tags on an input in the range [abs_start, abs_end).
+     * When work makes several queries in one call, the tags of the
+     * work window are indexed by key and offset on that input,
+     * so that per-packet lookups do not rescan every tag in the buffer.
+     */
     void get_tags_in_range(
         std::vector<gr_tag_t> &tags,
         unsigned int which_input,
@@ -205,6 +282,81 @@ public:
      */
     gr_tag_t pop_msg_queue(void);
 
+    /*!
+     * \brief Pop a message from the front of the queue, with a timeout.
+     * \param msg the popped message as a tag type
+     * \param timeout seconds to wait for a message (negative waits forever)
+     * \return true if a message was popped, false on timeout
+     */
+    bool pop_msg_queue(gr_tag_t &msg, const double timeout);
+
+    /*!
+     * \brief Wait for a message or for new stream input.
+     * Wakes when a message is ready to pop, or when an upstream block
+     * has produced input since this call to work() began.
+     * Call this from work() to combine messages with periodic work,
+     * ex: wait with a 1ms timeout and flush output on timeout.
+     *
+     * \param timeout seconds to wait (negative waits forever)
+     * \return true if woken by a message or input, false on timeout
+     */
+    bool wait_msg_or_input(const double timeout);
+
+    /*!
+     * \brief Pop a batch of messages from the front of the queue.
+     * This function waits for the first message,
+     * and then takes any other messages that are already available.
+     *
+     * \param msgs the popped messages are appended to this vector
+     * \param max the maximum number of messages to pop
+     * \param timeout seconds to wait for the first message (negative waits forever)
+     * \return the number of messages popped, 0 on timeout
+     */
+    size_t pop_msg_queue_batch(
+        std::vector<gr_tag_t> &msgs,
+        const size_t max,
+        const double timeout = -1.0
+    );
+
+    //! What a full message input port does with another message
+    enum msg_overflow_policy
+    {
+        MSG_OVERFLOW_BLOCK = 0, //!< the poster sleeps until there is room
+        MSG_OVERFLOW_DROP_NEWEST = 1, //!< the new message is dropped
+        MSG_OVERFLOW_DROP_OLDEST = 2, //!< the oldest queued message is dropped
+    };
+
+    /*!
+     * \brief Bound the queue of a message input port.
+     * Each message input port has its own queue (1024 messages by default).
+     * Messages keep their order within a port, but not across ports.
+     * Call this before the flow graph is started.
+     *
+     * \param port the index of the message input port
+     * \param capacity the maximum number of queued messages
+     * \param policy what to do with a message when the queue is full
+     */
+    void set_msg_queue_capacity(
+        const size_t port,
+        const size_t capacity,
+        const msg_overflow_policy policy = MSG_OVERFLOW_BLOCK
+    );
+
+    //! Get the number of messages dropped on a message input port
+    size_t msg_queue_dropped(const size_t port);
+
+    /*!
+     * The priority class of a posted message.
+     * A message input port pops control messages before bulk messages,
+     * so a setting change does not wait behind queued data.
+     * Control messages always block on overflow, they are never dropped.
+     */
+    enum msg_priority
+    {
+        MSG_PRIORITY_BULK = 0, //!< data, subject to the overflow policy
+        MSG_PRIORITY_CONTROL = 1, //!< settings and commands, popped first
+    };
+
     /*!
      * \brief Post a message to a message source port on this block.
      * All message sinks connected to this port will get this message.
@@ -212,8 +364,13 @@ public:
      *
      * \param port the index of the message source port
      * \param msg the message to post to all subscribers
+     * \param priority the priority class of the message
      */
-    void post_msg(const size_t port, const gr_tag_t &msg);
+    void post_msg(
+        const size_t port,
+        const gr_tag_t &msg,
+        const msg_priority priority = MSG_PRIORITY_BULK
+    );
 
     /*!
      * \brief Post a message to a message source port on this block.
@@ -223,14 +380,100 @@ public:
      * \param key the tag key as a PMT symbol
      * \param value any PMT holding any value for the given key
      * \param srcid optional source ID specifier; defaults to PMT_F
+     * \param priority the priority class of the message
      */
     void post_msg(
         const size_t port,
         const pmt::pmt_t &key,
         const pmt::pmt_t &value,
-        const pmt::pmt_t &srcid=pmt::PMT_F
+        const pmt::pmt_t &srcid=pmt::PMT_F,
+        const msg_priority priority = MSG_PRIORITY_BULK
     );
 
+    /*!
+     * \brief Post a batch of messages to a message source port on this block.
+     * Same as calling post_msg for each message in order,
+     * but the subscribers are only notified once for the whole batch.
+     * The messages of a batch are bulk priority.
+     *
+     * \param port the index of the message source port
+     * \param msgs the messages to post to all subscribers
+     */
+    void post_msgs(const size_t port, const std::vector<gr_tag_t> &msgs);
+
+    /*******************************************************************
+     * Performance monitoring
+     ******************************************************************/
+
+    /*!
+     * \brief Get a snapshot of the performance counters.
+     * The counters accumulate over the lifetime of the block.
+     * Item counts are only available while in a flow graph.
+     */
+    block_perf_counters perf_counters(void);
+
+    /*!
+     * \brief Enable or disable the tracer for all blocks.
+     * When enabled, each call to work(), post_msg(), and pop_msg_queue()
+     * is recorded with its begin and end times into a ring of the calling thread.
+     * When disabled, the cost is a single load per call.
+     */
+    static void set_tracing(const bool enable);
+
+    /*!
+     * \brief Write the recorded events to a trace file.
+     * The file is in the Chrome trace event JSON format,
+     * view it with chrome://tracing or ui.perfetto.dev.
+     * Each thread keeps its most recent 16384 events.
+     * \param path the path of the file to write
+     */
+    static void write_trace(const std::string &path);
+
+    /*!
+     * \brief Discard the recorded events.
+     * Call between runs so the next trace file only has the new events.
+     */
+    static void clear_trace(void);
+
+    /*******************************************************************
+     * Thread scheduling
+     ******************************************************************/
+
+    /*!
+     * \brief Pin the threads of this block to a set of processors.
+     * This applies to every thread the block owns:
+     * the thread that calls work() and those of the message ports.
+     * The setting is applied when the flow graph is started.
+     * \param cpus the processor indexes, empty to leave as is
+     */
+    void set_processor_affinity(const std::vector<int> &cpus);
+
+    std::vector<int> processor_affinity(void) const;
+
+    /*!
+     * \brief Set the scheduling priority of the threads of this block.
+     * This applies to the same threads as set_processor_affinity().
+     * Realtime priority usually needs elevated permissions,
+     * a failure is reported on stderr and the flow graph runs regardless.
+     * \param priority -1.0 (lowest) to 1.0 (highest), 0.0 is normal
+     * \param realtime true for a realtime scheduling class
+     */
+    void set_thread_priority(const double priority, const bool realtime = true);
+
+    /*!
+     * \brief Split large calls to work() across a shared pool of threads.
+     * Blocks that support it, such as the arithmetic ops,
+     * process the buffers of one call in cache sized chunks
+     * on the pool and on the thread of the block at the same time.
+     * Smaller calls stay on the thread of the block.
+     * The pool has a thread per processor less one,
+     * the environment variable EXTRAS_WORK_THREADS overrides the count.
+     * \param min_items the fewest output items to split, 0 never splits
+     */
+    void set_work_split(const size_t min_items);
+
+    size_t work_split(void) const;
+
     /*******************************************************************
      * Work related routines from basic block
      ******************************************************************/
@@ -47,6 +47,14 @@ public:
 
     //! Get the constant value as a complex double
     virtual std::complex<double> get_const(void) = 0;
+
+    /*!
+     * Clamp the sums to the range of the type instead of wrapping.
+     * Only the 8 and 16 bit integer blocks saturate, the others ignore it.
+     * The constant is in the integer units of the type.
+     * Default: false, wrap around like the C++ arithmetic.
+     */
+    virtual void set_saturate(const bool saturate) = 0;
 };
 
 class GR_EXTRAS_API add_const_v : virtual public block{
@@ -73,6 +81,9 @@ public:
     //! Get the constant value as a vector of complex double
     virtual std::vector<std::complex<double> > get_const(void) = 0;
 
+    //! Same as the scalar block above
+    virtual void set_saturate(const bool saturate) = 0;
+
 private:
     virtual void _set_const(const std::vector<std::complex<double> > &val) = 0;
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_CONVERT_H
+#define INCLUDED_GR_EXTRAS_CONVERT_H
+
+#include <gnuradio/extras/api.h>
+#include <gnuradio/block.h>
+
+namespace gnuradio{ namespace extras{
+
+/*!
+ * Convert a stream between the integer types and float,
+ * multiplying by a scale factor on the way: out = in * scale.
+ *
+ * Integer outputs round to nearest and clamp to the range
+ * of the type, so an overdriven float stream does not wrap.
+ * Complex types convert the real and imaginary parts alike.
+ */
+class GR_EXTRAS_API convert : virtual public block{
+public:
+    typedef boost::shared_ptr<convert> sptr;
+
+    /*!
+     * Make a new converter, the suffix is input type then output type.
+     * \param scale the factor applied to every number
+     * \param vlen the vector length of the items
+     */
+    static sptr make_sc32_fc32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_sc16_fc32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_sc8_fc32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_fc32_sc32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_fc32_sc16(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_fc32_sc8(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_s32_f32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_s16_f32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_s8_f32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_f32_s32(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_f32_s16(const double scale = 1.0, const size_t vlen = 1);
+    static sptr make_f32_s8(const double scale = 1.0, const size_t vlen = 1);
+
+    //! Set the scale factor, safe to call while running
+    virtual void set_scale(const double scale) = 0;
+
+    //! Get the scale factor
+    virtual double get_scale(void) = 0;
+};
+
+}}
+
+#endif /* INCLUDED_GR_EXTRAS_CONVERT_H */
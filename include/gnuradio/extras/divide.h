@@ -39,6 +39,15 @@ public:
     static sptr make_s32_s32(const size_t num_inputs, const size_t vlen = 1);
     static sptr make_s16_s16(const size_t num_inputs, const size_t vlen = 1);
     static sptr make_s8_s8(const size_t num_inputs, const size_t vlen = 1);
+
+    /*!
+     * Divide floats with a reciprocal estimate and one Newton step.
+     * The results are within a few ulp of exact division,
+     * and zero divisors give NaN instead of inf.
+     * Only the f32 blocks use it, and only where the estimate is faster.
+     * Default: false, exact division.
+     */
+    virtual void set_fast_reciprocal(const bool fast) = 0;
 };
 
 }}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_EXPRESSION_H
+#define INCLUDED_GR_EXTRAS_EXPRESSION_H
+
+#include <gnuradio/extras/api.h>
+#include <gnuradio/block.h>
+#include <string>
+
+namespace gnuradio{ namespace extras{
+
+/*!
+ * Evaluate an arithmetic expression over the input streams.
+ *
+ * The expression is a formula in the inputs in0, in1, ...
+ * with numeric constants like 2, -0.5, 1e-3 and 0.5j,
+ * the operators + - * / with the usual precedence,
+ * unary minus, and parentheses. Example: "0.5*in0 + (1-2j)*in1 + 3".
+ * The integer types take integer constants only, like "3*in0 + (1-2j)*in1 + 3".
+ *
+ * The arithmetic matches the extras ops of the same type:
+ * integers wrap, and complex types divide as complex numbers.
+ * Constant parts of the expression are folded when the block is made.
+ *
+ * Work is done in small tiles that pass through the whole expression
+ * while they are in cache, so a chain of ops costs one block,
+ * one thread, and one pass over memory.
+ */
+class GR_EXTRAS_API expression : virtual public block{
+public:
+    typedef boost::shared_ptr<expression> sptr;
+
+    /*!
+     * Make a new expression block.
+     * Imaginary constants are only allowed for the complex types,
+     * and the integer types (s16, sc16) only take integer constants.
+     * \param expr the expression text
+     * \param num_inputs the number of input streams, in0 to in(N-1)
+     * \param vlen the vector length of the items
+     */
+    static sptr make_fc32_fc32(const std::string &expr, const size_t num_inputs, const size_t vlen = 1);
+    static sptr make_sc16_sc16(const std::string &expr, const size_t num_inputs, const size_t vlen = 1);
+    static sptr make_f32_f32(const std::string &expr, const size_t num_inputs, const size_t vlen = 1);
+    static sptr make_s16_s16(const std::string &expr, const size_t num_inputs, const size_t vlen = 1);
+};
+
+}}
+
+#endif /* INCLUDED_GR_EXTRAS_EXPRESSION_H */
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_INPLACE_CHAIN_H
+#define INCLUDED_GR_EXTRAS_INPLACE_CHAIN_H
+
+#include <gnuradio/extras/api.h>
+#include <gnuradio/block.h>
+
+namespace gnuradio{ namespace extras{
+
+/*!
+ * Run a chain of in-place blocks over one buffer in a single thread.
+ *
+ * Each stage must be an extras block that declares set_inplace(true),
+ * with one input and one output of the same item size, and a rate of 1.
+ * Examples: add_const_v, multiply_const_v, and subtract/divide with 1 input.
+ *
+ * The first stage reads the input buffer and writes the output buffer,
+ * every other stage reads and writes the output buffer in place.
+ * Work is done in cache sized tiles that pass through every stage,
+ * so the chain costs one read and one write of memory, not one per stage.
+ * The stages are not connected to the flow graph, but setters on them,
+ * like set_const(), still apply to the chain.
+ * Only work() of a stage is called, so a stage must not use stream state:
+ * no history, nitems_read/written, tags, consume or produce.
+ * Stages with a history above 1 are rejected.
+ */
+class GR_EXTRAS_API inplace_chain : virtual public block{
+public:
+    typedef boost::shared_ptr<inplace_chain> sptr;
+
+    /*!
+     * Make a new in-place chain.
+     * \param stages the blocks to run, in order
+     */
+    static sptr make(const std::vector<gr_basic_block_sptr> &stages);
+};
+
+}}
+
+#endif /* INCLUDED_GR_EXTRAS_INPLACE_CHAIN_H */
@@ -39,6 +39,16 @@ public:
     static sptr make_s32_s32(const size_t num_inputs, const size_t vlen = 1);
     static sptr make_s16_s16(const size_t num_inputs, const size_t vlen = 1);
     static sptr make_s8_s8(const size_t num_inputs, const size_t vlen = 1);
+
+    /*!
+     * Multiply the 8 and 16 bit integer types as Q7 and Q15 fractions:
+     * each product is rounded, shifted down by 7 or 15 bits,
+     * and clamped to the range of the type, so 16384 * 16384 = 8192
+     * and -32768 * -32768 = 32767 for s16 and sc16.
+     * The other blocks ignore it.
+     * Default: false, plain integer products that wrap around.
+     */
+    virtual void set_saturate(const bool saturate) = 0;
 };
 
 }}
@@ -47,6 +47,15 @@ public:
 
     //! Get the constant value as a complex double
     virtual std::complex<double> get_const(void) = 0;
+
+    /*!
+     * Multiply the 8 and 16 bit integer types as Q7 and Q15 fractions,
+     * rounded and clamped to the range of the type like multiply.
+     * The constant is the raw fraction, 16384 is 0.5 for s16 and sc16.
+     * The other blocks ignore it.
+     * Default: false, plain integer products that wrap around.
+     */
+    virtual void set_saturate(const bool saturate) = 0;
 };
 
 class GR_EXTRAS_API multiply_const_v : virtual public block{
@@ -73,6 +82,9 @@ public:
     //! Get the constant value as a vector of complex double
     virtual std::vector<std::complex<double> > get_const(void) = 0;
 
+    //! Same as the scalar block above
+    virtual void set_saturate(const bool saturate) = 0;
+
 private:
     virtual void _set_const(const std::vector<std::complex<double> > &val) = 0;
 
@@ -49,6 +49,20 @@ public:
         const std::string &proto, const std::string &addr, const std::string &port, const size_t mtu = 0
     );
 
+    /*!
+     * Pin the threads of this block to a set of processors:
+     * the socket reader, the socket writer, and the connection acceptor.
+     * \param cpus the processor indexes, empty to leave as is
+     */
+    virtual void set_processor_affinity(const std::vector<int> &cpus) = 0;
+
+    /*!
+     * Set the scheduling priority of the threads of this block.
+     * \param priority -1.0 (lowest) to 1.0 (highest), 0.0 is normal
+     * \param realtime true for a realtime scheduling class
+     */
+    virtual void set_thread_priority(const double priority, const bool realtime = true) = 0;
+
 };
 
 }}
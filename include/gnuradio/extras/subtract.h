@@ -39,6 +39,13 @@ public:
     static sptr make_s32_s32(const size_t num_inputs, const size_t vlen = 1);
     static sptr make_s16_s16(const size_t num_inputs, const size_t vlen = 1);
     static sptr make_s8_s8(const size_t num_inputs, const size_t vlen = 1);
+
+    /*!
+     * Clamp the results to the range of the type instead of wrapping.
+     * Only the 8 and 16 bit integer blocks saturate, the others ignore it.
+     * Default: false, wrap around like the C++ arithmetic.
+     */
+    virtual void set_saturate(const bool saturate) = 0;
 };
 
 }}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_MSG_BLOCK_H
+#define INCLUDED_GR_EXTRAS_MSG_BLOCK_H
+
+#include <gnuradio/extras/api.h>
+#include <gnuradio/block.h>
+#include <gruel/pmt_extras.h>
+#include <gr_hier_block2.h>
+#include <gr_tags.h>
+
+namespace gnuradio{
+
+/*!
+ * A lightweight block for blocks that only pass messages.
+ *
+ * A gnuradio::block without stream IO costs one scheduler thread
+ * for the block, one for a hidden null sink, and one per message port.
+ * A msg_block is a single gr_block whose ports are the message ports,
+ * so every msg_block in a flow graph costs exactly one thread.
+ *
+ * Messages that arrive on an input port are passed to handle_msg().
+ * A msg_block without input ports is a message source:
+ * its thread sleeps until post_msg() is called from another thread.
+ */
+class GR_EXTRAS_API msg_block : public gr_hier_block2{
+public:
+    //! empty constructor for virtual inheritance
+    msg_block(void){}
+
+    /*!
+     * The msg block constructor.
+     * \param name the name of this block
+     * \param num_inputs the number of message input ports
+     * \param num_outputs the number of message output ports
+     */
+    msg_block(
+        const std::string &name,
+        const size_t num_inputs,
+        const size_t num_outputs
+    );
+
+    //! deconstructor
+    virtual ~msg_block(void);
+
+    /*!
+     * Handle a message from an input port.
+     * This is called from the block's thread, one message at a time.
+     * The default implementation drops the message.
+     * \param which_input the index of the message input port
+     * \param msg the message as a tag
+     */
+    virtual void handle_msg(const size_t which_input, const gr_tag_t &msg);
+
+    /*!
+     * The priority of the message being handled.
+     * Only valid inside handle_msg(), a relay passes it to post_msg()
+     * so that control messages stay ahead of bulk messages downstream.
+     */
+    block::msg_priority current_msg_priority(void) const;
+
+    /*!
+     * Post a message to a downstream subscriber.
+     *
+     * Posts from handle_msg() go out in the same call to work.
+     * Posts from other threads are queued and wake the block's thread;
+     * they block when the queue is full and downstream is behind.
+     *
+     * \param which_output the index of the message output port
+     * \param msg the message as a tag (offset is ignored)
+     * \param priority the priority class of the message, see block::msg_priority
+     */
+    void post_msg(
+        const size_t which_output,
+        const gr_tag_t &msg,
+        const block::msg_priority priority = block::MSG_PRIORITY_BULK
+    );
+
+    //! Post a message by key, value, source id, and priority
+    void post_msg(
+        const size_t which_output,
+        const pmt::pmt_t &key,
+        const pmt::pmt_t &value,
+        const pmt::pmt_t &srcid = pmt::PMT_F,
+        const block::msg_priority priority = block::MSG_PRIORITY_BULK
+    );
+
+    long unique_id(void) const;
+
+    std::string name(void) const;
+
+    //! Pin the block's thread to processors, see block::set_processor_affinity()
+    void set_processor_affinity(const std::vector<int> &cpus);
+
+    //! Set the block's thread priority, see block::set_thread_priority()
+    void set_thread_priority(const double priority, const bool realtime = true);
+
+    //! Called when the flow graph is started, can overload
+    virtual bool start(void);
+
+    //! Called when the flow graph is stopped, can overload
+    virtual bool stop(void);
+
+private:
+    //forward declared private guts
+    struct impl;
+    boost::shared_ptr<impl> _impl;
+};
+
+}
+
+#endif /* INCLUDED_GR_EXTRAS_MSG_BLOCK_H */
@@ -23,12 +23,36 @@
 #include <gr_io_signature.h>
 #include <stdexcept>
 #include <complex>
-#include <volk/volk.h>
+#include <boost/atomic.hpp>
+#include "op_kernels.h"
+#include "work_pool.h"
 
 using namespace gnuradio::extras;
 
 /***********************************************************************
- * Templated adder class
+ * Kernel selection, only the 8 and 16 bit integers saturate
+ **********************************************************************/
+template <typename type>
+static void add_items(type *out, const type *const *in, const size_t m, const size_t n, const bool){
+    gnuradio::kernels::add(out, in, m, n);
+}
+
+template <typename type>
+static void add_sat_items(type *out, const type *const *in, const size_t m, const size_t n, const bool saturate){
+    if (saturate) gnuradio::kernels::add_sat(out, in, m, n);
+    else gnuradio::kernels::add(out, in, m, n);
+}
+
+static void add_items(int8_t *out, const int8_t *const *in, const size_t m, const size_t n, const bool saturate){
+    add_sat_items(out, in, m, n, saturate);
+}
+
+static void add_items(int16_t *out, const int16_t *const *in, const size_t m, const size_t n, const bool saturate){
+    add_sat_items(out, in, m, n, saturate);
+}
+
+/***********************************************************************
+ * Templated adder class - calls the SIMD kernels
  **********************************************************************/
 template <typename type>
 class add_generic : public add{
@@ -39,78 +63,42 @@ public:
             gr_make_io_signature (num_inputs, num_inputs, sizeof(type)*vlen),
             gr_make_io_signature (1, 1, sizeof(type)*vlen)
         ),
-        _vlen(vlen)
+        _vlen(vlen),
+        _ins(num_inputs),
+        _saturate(false)
     {
-        const int alignment_multiple = get_work_multiple() / (sizeof(type)*vlen);
-        set_output_multiple(std::max(1, alignment_multiple));
+        //NOP
     }
 
-    size_t get_work_multiple(void);
+    void set_saturate(const bool saturate){
+        _saturate.store(saturate, boost::memory_order_relaxed);
+    }
 
     int work(
         const InputItems &input_items,
         const OutputItems &output_items
-    );
-
-private:
-    const size_t _vlen;
-};
-
-/***********************************************************************
- * Generic adder implementation
- **********************************************************************/
-template <typename type>
-size_t add_generic<type>::get_work_multiple(void)
-{
-    return 1;
-}
-
-template <typename type>
-int add_generic<type>::work(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t n_nums = output_items[0].size() * _vlen;
-    type *out = output_items[0].cast<type *>();
-    const type *in0 = input_items[0].cast<const type *>();
-
-    for (size_t n = 1; n < input_items.size(); n++){
-        const type *in = input_items[n].cast<const type *>();
-        for (size_t i = 0; i < n_nums; i++){
-            out[i] = in0[i] + in[i];
+    ){
+        for (size_t n = 0; n < input_items.size(); n++){
+            _ins[n] = input_items[n].cast<const type *>();
         }
-        in0 = out; //for next input, we do output += input
-    }
-
-    return output_items[0].size();
-}
 
-/***********************************************************************
- * Adder implementation with float32 - calls volk
- **********************************************************************/
-template <>
-size_t add_generic<float>::get_work_multiple(void)
-{
-    return volk_get_alignment();
-}
-
-template <>
-int add_generic<float>::work(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t n_nums = output_items[0].size() * _vlen;
-    float *out = output_items[0].cast<float *>();
-    const float *in0 = input_items[0].cast<const float *>();
-
-    for (size_t n = 1; n < input_items.size(); n++){
-        const float *in = input_items[n].cast<const float *>();
-        volk_32f_x2_add_32f_a(out, in0, in, n_nums);
-        in0 = out; //for next input, we do output += input
+        //one pass over all inputs, output = input0 + input1 + ...
+        const size_t noutput_items = output_items[0].size();
+        const size_t n_nums = noutput_items * _vlen;
+        const size_t split = this->work_split();
+        gnuradio::parallel_nary(
+            &add_items, output_items[0].cast<type *>(), &_ins[0], _ins.size(), n_nums,
+            _saturate.load(boost::memory_order_relaxed), split != 0 && noutput_items >= split, _chunk_ins
+        );
+        return noutput_items;
     }
 
-    return output_items[0].size();
-}
+private:
+    const size_t _vlen;
+    std::vector<const type *> _ins;
+    std::vector<const type *> _chunk_ins;
+    boost::atomic<bool> _saturate;
+};
 
 /***********************************************************************
  * factory function
@@ -21,6 +21,7 @@
 
 #include <gnuradio/extras/blob_to_filedes.h>
 #include <gr_io_signature.h>
+#include <boost/thread/thread.hpp>
 #include <iostream>
 
 #ifdef HAVE_IO_H
@@ -30,6 +31,8 @@
 
 using namespace gnuradio::extras;
 
+static const double timeout_s = 0.1; //100ms
+
 class blob_to_filedes_impl : public blob_to_filedes{
 public:
     blob_to_filedes_impl(const int fd, const bool close):
@@ -54,8 +57,9 @@ public:
         const OutputItems &
     ){
         //loop for blobs until this thread is interrupted
-        while (true){
-            gr_tag_t msg = this->pop_msg_queue();
+        while (!boost::this_thread::interruption_requested()){
+            gr_tag_t msg;
+            if (!this->pop_msg_queue(msg, timeout_s)) continue;
             if (!pmt::pmt_is_blob(msg.value)) continue;
             if (pmt::pmt_blob_length(msg.value) == 0) break; //empty blob, we are done here
             const int result = write(
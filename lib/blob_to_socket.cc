@@ -22,11 +22,14 @@
 #include <gnuradio/extras/blob_to_socket.h>
 #include <gr_io_signature.h>
 #include <boost/asio.hpp>
+#include <boost/foreach.hpp>
 
 namespace asio = boost::asio;
 
 using namespace gnuradio::extras;
 
+static const size_t BATCH_SIZE = 64; //max num blobs to pop at once
+
 /***********************************************************************
  * UDP Implementation
  **********************************************************************/
@@ -55,22 +58,23 @@ public:
     ){
         //loop for blobs until this thread is interrupted
         while (true){
-            gr_tag_t msg = this->pop_msg_queue();
-            if (!pmt::pmt_is_blob(msg.value)) continue;
-            if (pmt::pmt_blob_length(msg.value) == 0) break; //empty blob, we are done here
-            _socket->send(asio::buffer(
-                pmt::pmt_blob_data(msg.value),
-                pmt::pmt_blob_length(msg.value)
-            ));
+            _msgs.clear();
+            this->pop_msg_queue_batch(_msgs, BATCH_SIZE);
+            BOOST_FOREACH(const gr_tag_t &msg, _msgs){
+                if (!pmt::pmt_is_blob(msg.value)) continue;
+                if (pmt::pmt_blob_length(msg.value) == 0) return -1; //empty blob, we are done here
+                _socket->send(asio::buffer(
+                    pmt::pmt_blob_data(msg.value),
+                    pmt::pmt_blob_length(msg.value)
+                ));
+            }
         }
-
-        //when handle msgs finished, work is marked done
-        return -1;
     }
 
 private:
     asio::io_service _io_service;
     boost::shared_ptr<asio::ip::udp::socket> _socket;
+    std::vector<gr_tag_t> _msgs;
 };
 
 /***********************************************************************
@@ -108,14 +112,25 @@ public:
         const OutputItems &
     ){
         //loop for blobs until this thread is interrupted
-        while (true){
-            gr_tag_t msg = this->pop_msg_queue();
-            if (!pmt::pmt_is_blob(msg.value)) continue;
-            if (pmt::pmt_blob_length(msg.value) == 0) break; //empty blob, we are done here
-            _socket->send(asio::buffer(
-                pmt::pmt_blob_data(msg.value),
-                pmt::pmt_blob_length(msg.value)
-            ));
+        bool done = false;
+        while (!done){
+            _msgs.clear();
+            _buffs.clear();
+            this->pop_msg_queue_batch(_msgs, BATCH_SIZE);
+            BOOST_FOREACH(const gr_tag_t &msg, _msgs){
+                if (!pmt::pmt_is_blob(msg.value)) continue;
+                if (pmt::pmt_blob_length(msg.value) == 0){
+                    done = true; //empty blob, we are done here
+                    break;
+                }
+                _buffs.push_back(asio::buffer(
+                    pmt::pmt_blob_data(msg.value),
+                    pmt::pmt_blob_length(msg.value)
+                ));
+            }
+
+            //the stream is contiguous, so write the whole batch at once
+            asio::write(*_socket, _buffs);
         }
 
         //when handle msgs finished, work is marked done
@@ -127,6 +142,8 @@ private:
     asio::ip::tcp::endpoint _endpoint;
     boost::shared_ptr<asio::ip::tcp::socket> _socket;
     bool _connected;
+    std::vector<gr_tag_t> _msgs;
+    std::vector<asio::const_buffer> _buffs;
 };
 
 /***********************************************************************
@@ -21,16 +21,23 @@
 
 //gr implementation headers
 #include <gr_block.h>
+#include <gr_block_detail.h>
+#include <gr_buffer.h>
 #include <gr_io_signature.h>
+#include <gr_tpb_detail.h>
 
 #include <gnuradio/block.h>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
-#include <boost/thread/thread.hpp>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/condition_variable.hpp>
 #include <boost/make_shared.hpp>
-#include <queue>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "msg_inbox.h"
+#include "perf_ticks.h"
+#include "block_trace.h"
+#include "thread_sched.h"
+#include "tag_index.h"
 
 using namespace gnuradio;
 
@@ -39,43 +46,130 @@ static int mylround(double x)
     return int(x + 0.5);
 }
 
-template <typename T>
-struct MyQueue
+static int mygcd(int a, int b)
 {
+    while (b != 0)
+    {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+//! tag queries per work call on a port before its tag index is built,
+//! a few scans cost less than building the index
+static const size_t TAG_INDEX_MIN_QUERIES = 4;
+
+/***********************************************************************
+ * Direct message channel between a sourcer and a sinker
+ *
+ * When every reader of a sourcer's stream is a sinker of another block,
+ * post_msg() hands messages straight to the sinkers' queues and the
+ * 1-byte tag-carrying stream goes idle. Messages that were already on
+ * the stream are followed by a cutover tag; direct messages are held
+ * until the sinker has seen this tag so that ordering is preserved.
+ **********************************************************************/
+static const pmt::pmt_t &msg_cutover_key(void)
+{
+    static const pmt::pmt_t key = pmt::pmt_string_to_symbol("extras_msg_cutover");
+    return key;
+}
+
+/***********************************************************************
+ * Message priority on the stream
+ *
+ * A control message is preceded by a marker tag at the same offset,
+ * the sinker puts the message after a marker into the control lane.
+ * In the sourcer queue, a control message is flagged by its offset.
+ **********************************************************************/
+static const pmt::pmt_t &msg_priority_key(void)
+{
+    static const pmt::pmt_t key = pmt::pmt_string_to_symbol("extras_msg_control");
+    return key;
+}
+
+static const uint64_t msg_control_offset = ~uint64_t(0);
+
+typedef msg_port<gr_tag_t>::priority msg_port_priority;
 
-    void push(const T &msg)
+struct msg_subscription
+{
+    msg_subscription(msg_port<gr_tag_t> *port, const size_t index):
+        port(port), index(index), cut(false), detached(false)
     {
-        boost::mutex::scoped_lock lock(_msg_queue_mutex);
-        _msg_queue.push(msg);
-        lock.unlock();
-        _msg_queue_condition_variable.notify_one();
+        //NOP
     }
 
-    bool ready(void)
+    //! called by the sourcer's post_msg() in direct mode
+    void deliver(gr_tag_t msg, const msg_port_priority prio)
     {
-        boost::mutex::scoped_lock lock(_msg_queue_mutex);
-        return !_msg_queue.empty();
+        msg.offset = index;
+        if (!cut.load(boost::memory_order_acquire))
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            if (!cut.load(boost::memory_order_relaxed))
+            {
+                if (prio == msg_port<gr_tag_t>::PRIORITY_CONTROL) held_control.push_back(msg);
+                else held.push_back(msg);
+                return;
+            }
+        }
+        port->push(msg, prio, &detached);
     }
 
-    T pop(void)
+    //! called by the sourcer's post_msgs() in direct mode
+    void deliver(const std::vector<gr_tag_t> &msgs)
     {
-        boost::mutex::scoped_lock lock(_msg_queue_mutex);
-        while (_msg_queue.empty())
+        std::vector<gr_tag_t> batch(msgs);
+        BOOST_FOREACH(gr_tag_t &msg, batch)
         {
-            _msg_queue_condition_variable.wait(lock);
+            msg.offset = index;
         }
+        if (!cut.load(boost::memory_order_acquire))
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            if (!cut.load(boost::memory_order_relaxed))
+            {
+                held.insert(held.end(), batch.begin(), batch.end());
+                return;
+            }
+        }
+        port->push_batch(batch.begin(), batch.end(), &detached);
+    }
 
-        T msg = _msg_queue.front();
-        _msg_queue.front() = T(); //resets ref counts
-        _msg_queue.pop();
-        return msg;
+    //! called by the sinker when the cutover tag arrives
+    void cutover(void)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        BOOST_FOREACH(const gr_tag_t &msg, held_control)
+        {
+            port->push(msg, msg_port<gr_tag_t>::PRIORITY_CONTROL);
+        }
+        port->push_batch(held.begin(), held.end());
+        held_control.clear();
+        held.clear();
+        cut.store(true, boost::memory_order_release);
     }
 
-    std::queue<T> _msg_queue;
-    boost::mutex _msg_queue_mutex;
-    boost::condition_variable _msg_queue_condition_variable;
+    //! called by the sourcer on stop, releases a deliver() blocked on a full port
+    void detach(void)
+    {
+        detached.store(true, boost::memory_order_seq_cst);
+        port->wake_pushers();
+    }
+
+    msg_port<gr_tag_t> *port;
+    const size_t index;
+    boost::atomic<bool> cut;
+    boost::atomic<bool> detached;
+    boost::mutex mutex;
+    std::vector<gr_tag_t> held;
+    std::vector<gr_tag_t> held_control;
 };
 
+typedef boost::shared_ptr<msg_subscription> msg_subscription_sptr;
+
 /***********************************************************************
  * The message sourcer object
  **********************************************************************/
@@ -87,21 +181,37 @@ public:
             "msg_sourcer",
             gr_make_io_signature(0, 0, 0),
             gr_make_io_signature(1, 1, 1)
-        )
+        ),
+        sched(NULL), _direct(false), _posting(0)
     {
         //NOP
     }
 
     bool start(void)
     {
-        _done = false;
+        if (sched) sched->apply();
+        _nreaders = this->detail()->output(0)->nreaders();
+        _cutover_pending = false;
+        _msg_queue.open();
         return true;
     }
 
     bool stop(void)
     {
-        _done = true;
-        _msg_queue_condition_variable.notify_one(); //if working, wakes up work to return -1
+        _msg_queue.close(); //if working, wakes up work to return -1
+
+        //fall back to the stream and release any blocked direct posts
+        _direct.store(false, boost::memory_order_seq_cst);
+        boost::mutex::scoped_lock lock(_sub_mutex);
+        BOOST_FOREACH(const msg_subscription_sptr &sub, _subscribers)
+        {
+            sub->detach();
+        }
+        while (_posting.load(boost::memory_order_seq_cst) != 0)
+        {
+            boost::this_thread::yield();
+        }
+        _subscribers.clear();
         return true;
     }
 
@@ -111,40 +221,113 @@ public:
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items
     ){
-        //loop for the msg from the producer
-        boost::mutex::scoped_lock lock(_msg_queue_mutex);
-        while (_msg_queue.empty())
+        //after the switch, flush the stream and then send the cutover tag
+        if (_cutover_pending)
+        {
+            //posts that raced the switch may still be landing in the queue
+            while (_posting.load(boost::memory_order_seq_cst) != 0 && _msg_queue.empty())
+            {
+                boost::this_thread::yield();
+            }
+            if (_msg_queue.empty())
+            {
+                _cutover_pending = false;
+                this->add_item_tag(0, this->nitems_written(0), msg_cutover_key(), pmt::PMT_T, pmt::PMT_F);
+                return noutput_items;
+            }
+        }
+
+        //wait for msgs from the producer, take up to one per output item
+        if (_msg_queue.pop_batch(_msgs, size_t(noutput_items), -1.0) == 0) return -1;
+
+        //push the msgs downstream
+        const uint64_t nwritten = this->nitems_written(0);
+        for (size_t i = 0; i < _msgs.size(); i++)
         {
-            if (_done) return -1;
-            _msg_queue_condition_variable.wait(lock);
+            if (_msgs[i].offset == msg_control_offset)
+            {
+                this->add_item_tag(0, nwritten + i, msg_priority_key(), pmt::PMT_T, pmt::PMT_F);
+            }
+            _msgs[i].offset = nwritten + i;
+            this->add_item_tag(0, _msgs[i]);
         }
+        _msgs.clear(); //resets PMT refs
 
-        //push the msg downstream
-        gr_tag_t msg = _msg_queue.front();
-        _msg_queue.front() = gr_tag_t(); //resets PMT ref counts
-        _msg_queue.pop();
-        msg.offset = this->nitems_written(0);
-        this->add_item_tag(0, msg);
+        //every reader has subscribed: future posts take the direct path
+        if (!_direct.load(boost::memory_order_relaxed) && this->all_subscribed())
+        {
+            _direct.store(true, boost::memory_order_seq_cst);
+            _cutover_pending = true;
+        }
 
         //return produced
         //produce entire buffer so work has to get called again
         return noutput_items;
     }
 
-    void post_msg(const gr_tag_t &msg)
+    void post_msg(const gr_tag_t &msg, const msg_port_priority prio)
+    {
+        _posting.fetch_add(1, boost::memory_order_seq_cst);
+        if (_direct.load(boost::memory_order_seq_cst))
+        {
+            BOOST_FOREACH(const msg_subscription_sptr &sub, _subscribers)
+            {
+                sub->deliver(msg, prio);
+            }
+        }
+        else
+        {
+            gr_tag_t queued = msg;
+            const bool control = prio == msg_port<gr_tag_t>::PRIORITY_CONTROL;
+            queued.offset = control? msg_control_offset : 0;
+            _msg_queue.push(queued);
+        }
+        _posting.fetch_sub(1, boost::memory_order_release);
+    }
+
+    void post_msgs(const std::vector<gr_tag_t> &msgs)
     {
-        boost::mutex::scoped_lock lock(_msg_queue_mutex);
-        _msg_queue.push(msg);
-        lock.unlock();
-        _msg_queue_condition_variable.notify_one();
+        _posting.fetch_add(1, boost::memory_order_seq_cst);
+        if (_direct.load(boost::memory_order_seq_cst))
+        {
+            BOOST_FOREACH(const msg_subscription_sptr &sub, _subscribers)
+            {
+                sub->deliver(msgs);
+            }
+        }
+        else
+        {
+            _msg_queue.push_batch(msgs.begin(), msgs.end());
+        }
+        _posting.fetch_sub(1, boost::memory_order_release);
+    }
+
+    //! called by a downstream sinker when its block starts
+    msg_subscription_sptr subscribe(msg_port<gr_tag_t> *port, const size_t index)
+    {
+        msg_subscription_sptr sub = boost::make_shared<msg_subscription>(port, index);
+        boost::mutex::scoped_lock lock(_sub_mutex);
+        _subscribers.push_back(sub);
+        return sub;
     }
 
+    const thread_sched *sched;
+
 private:
-    std::vector<gr_tag_t> _tags;
-    std::queue<gr_tag_t> _msg_queue;
-    boost::mutex _msg_queue_mutex;
-    boost::condition_variable _msg_queue_condition_variable;
-    bool _done;
+    bool all_subscribed(void)
+    {
+        boost::mutex::scoped_lock lock(_sub_mutex);
+        return _nreaders != 0 && _subscribers.size() == _nreaders;
+    }
+
+    msg_queue<gr_tag_t> _msg_queue;
+    std::vector<gr_tag_t> _msgs;
+    boost::atomic<bool> _direct;
+    boost::atomic<size_t> _posting;
+    bool _cutover_pending;
+    size_t _nreaders;
+    boost::mutex _sub_mutex;
+    std::vector<msg_subscription_sptr> _subscribers;
 };
 
 /***********************************************************************
@@ -158,11 +341,30 @@ public:
             "msg_sinker",
             gr_make_io_signature(1, 1, 1),
             gr_make_io_signature(0, 0, 0)
-        )
+        ),
+        sched(NULL)
     {
         //NOP
     }
 
+    bool start(void)
+    {
+        if (sched) sched->apply();
+
+        //subscribe to the upstream sourcer when it is another extras block
+        _sub.reset();
+        gr_block_sptr writer = this->detail()->input(0)->buffer()->link();
+        msg_sourcer *sourcer = dynamic_cast<msg_sourcer *>(writer.get());
+        if (sourcer != NULL) _sub = sourcer->subscribe(this->port, this->index);
+        return true;
+    }
+
+    bool stop(void)
+    {
+        _sub.reset();
+        return true;
+    }
+
     int general_work(
         int noutput_items,
         gr_vector_int &ninput_items,
@@ -174,23 +376,49 @@ public:
         this->get_tags_in_range(_tags, 0, nread, nread+ninput_items[0]);
         this->consume(0, ninput_items[0]); //consume port 0 input
 
-        //push the tags in the queue
+        //push the tags in the queue, in batches between cutover tags,
+        //control messages skip the batch and go straight to their lane
+        bool control = false;
         BOOST_FOREACH(gr_tag_t &msg, _tags)
         {
-            msg.offset = this->index;
-            this->queue->push(msg);
-            msg = gr_tag_t(); //resets PMT ref in _tags
+            if (pmt::pmt_eq(msg.key, msg_cutover_key()))
+            {
+                this->port->push_batch(_msgs.begin(), _msgs.end());
+                _msgs.clear();
+                if (_sub) _sub->cutover();
+            }
+            else if (pmt::pmt_eq(msg.key, msg_priority_key()))
+            {
+                control = true;
+            }
+            else if (control)
+            {
+                msg.offset = this->index;
+                this->port->push(msg, msg_port<gr_tag_t>::PRIORITY_CONTROL);
+                control = false;
+            }
+            else
+            {
+                msg.offset = this->index;
+                _msgs.push_back(msg);
+            }
         }
+        this->port->push_batch(_msgs.begin(), _msgs.end());
+        _msgs.clear(); //resets PMT refs
+        _tags.clear();
 
         //return produced
         return 0;
     }
 
     size_t index;
-    MyQueue<gr_tag_t> *queue;
+    msg_port<gr_tag_t> *port;
+    const thread_sched *sched;
 
 private:
     std::vector<gr_tag_t> _tags;
+    std::vector<gr_tag_t> _msgs;
+    msg_subscription_sptr _sub;
 };
 
 /***********************************************************************
@@ -206,12 +434,18 @@ public:
         block *parent,
         std::vector<boost::shared_ptr<msg_sourcer> > *sourcers
     ):
-        gr_block(name, in_sig, out_sig)
+        gr_block(name, in_sig, out_sig),
+        sched(NULL), work_calls(0), work_ticks_total(0), work_ticks_max(0),
+        _user_multiple(1), _base_multiple(1), _min_noutput(0), _max_noutput(0),
+        _interp(1), _decim(1), _rate_phase(0)
     {
         _parent = parent;
         _sourcers = sourcers;
         _input_items.resize(in_sig->max_streams());
         _output_items.resize(out_sig->max_streams());
+        _tag_index.resize(in_sig->max_streams());
+        _tag_queries.resize(in_sig->max_streams(), 0);
+        _window_end.resize(in_sig->max_streams(), 0);
     }
 
     /*******************************************************************
@@ -221,6 +455,9 @@ public:
         int noutput_items,
         gr_vector_int &ninput_items_required
     ){
+        //only ask for the input that work will be given
+        noutput_items = this->clip_noutput(noutput_items);
+
         if (!_automatic)
         {
             return _parent->forecast(noutput_items, ninput_items_required);
@@ -228,6 +465,9 @@ public:
 
         else
         {
+            //let the tail at the end of the stream through
+            const int tail = this->tail_noutput();
+            if (tail > 0) noutput_items = std::min(noutput_items, tail);
             for (size_t i = 0; i < ninput_items_required.size(); i++)
             {
                 ninput_items_required[i] = fixed_rate_noutput_to_ninput(noutput_items);
@@ -241,9 +481,20 @@ public:
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items
     ){
+        noutput_items = this->clip_noutput(noutput_items);
+        if (_automatic)
+        {
+            const int tail = this->tail_noutput();
+            if (tail > 0) noutput_items = std::min(noutput_items, tail);
+        }
+
         //fill buffers
         for (size_t i = 0; i < _input_items.size(); i++)
         {
+            const uint64_t nread = this->nitems_read(i);
+            _tag_index[i].prune(nread);
+            _tag_queries[i] = 0;
+            _window_end[i] = nread + ninput_items[i];
             _input_items[i]._mem = input_items[i];
             if (_automatic)
                 _input_items[i]._len = fixed_rate_noutput_to_ninput(noutput_items);
@@ -257,12 +508,21 @@ public:
         }
 
         //call work
+        const long long t0 = perf_ticks();
         const int r = _parent->work(_input_items, _output_items);
+        const long long dt = perf_ticks() - t0;
+
+        if (trace::enabled()) trace::record(trace::EVENT_WORK, this->unique_id(), t0, t0 + dt);
+
+        //update counters, this thread is the only writer
+        work_calls.store(work_calls.load(boost::memory_order_relaxed) + 1, boost::memory_order_relaxed);
+        work_ticks_total.store(work_ticks_total.load(boost::memory_order_relaxed) + dt, boost::memory_order_relaxed);
+        if (dt > work_ticks_max.load(boost::memory_order_relaxed)) work_ticks_max.store(dt, boost::memory_order_relaxed);
 
         //consume when in sync
         if (_automatic && r > 0)
         {
-            consume_each(mylround(r/this->relative_rate()));
+            consume_each(this->ninput_consumed(r));
         }
 
         //stop the sourcers when done
@@ -278,21 +538,118 @@ public:
     }
 
     int fixed_rate_noutput_to_ninput(int noutput_items){
-        return mylround((noutput_items/this->relative_rate()) + history() - 1);
+        if (_interp == 0) return mylround((noutput_items/this->relative_rate()) + history() - 1);
+        const long long needed = (long long)(noutput_items)*_decim + _rate_phase;
+        return int((needed + _interp - 1)/_interp) + history() - 1;
     }
 
     int fixed_rate_ninput_to_noutput(int ninput_items){
-        return mylround(std::max(0, ninput_items - (int)history() + 1)*this->relative_rate());
+        if (_interp == 0) return mylround(std::max(0, ninput_items - (int)history() + 1)*this->relative_rate());
+        const long long avail = (long long)(std::max(0, ninput_items - (int)history() + 1))*_interp - _rate_phase;
+        return int(std::max(0LL, avail)/_decim);
+    }
+
+    //! Set an exact rational rate, automatic consumption is then exact
+    void set_rate(const int interp, const int decim)
+    {
+        const int g = mygcd(interp, decim);
+        _interp = interp/g;
+        _decim = decim/g;
+        _rate_phase = 0;
+        gr_block::set_relative_rate(double(_interp)/_decim);
+        this->update_output_multiple();
+    }
+
+    //! Set a rate that is not rational, automatic consumption rounds
+    void set_inexact_rate(const double relative_rate)
+    {
+        _interp = 0;
+        _decim = 0;
+        gr_block::set_relative_rate(relative_rate);
+        this->update_output_multiple();
     }
 
     bool start(void){
+        if (sched) sched->apply();
         return _parent->start();
     }
 
+    //! wake work() sleeping in wait_msg_or_input()
+    void notify_input(void)
+    {
+        gr_block_detail_sptr d = this->detail();
+        if (d) d->d_tpb.set_input_changed();
+    }
+
+    bool wait_msg_or_input(msg_inbox<gr_tag_t> &queue, const double timeout)
+    {
+        //without stream inputs, there is only the queue to wait on
+        gr_block_detail_sptr d = this->detail();
+        if (!d || d->ninputs() == 0) return queue.wait(timeout);
+
+        //otherwise sleep on the scheduler's input condition,
+        //which upstream blocks signal when they produce,
+        //and which the queue signals through its notify hook
+        const boost::system_time deadline = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        gr_tpb_detail &tpb = d->d_tpb;
+        queue.begin_hook_wait();
+        bool ready = false;
+        {
+            gruel::scoped_lock lock(tpb.mutex);
+            while (!(ready = !queue.empty() || tpb.input_changed))
+            {
+                if (timeout < 0) tpb.input_cond.wait(lock);
+                else if (!tpb.input_cond.timed_wait(lock, deadline))
+                {
+                    ready = !queue.empty() || tpb.input_changed;
+                    break;
+                }
+            }
+        }
+        queue.end_hook_wait();
+        return ready;
+    }
+
     bool stop(void){
         return _parent->stop();
     }
 
+    void set_user_output_multiple(const int multiple)
+    {
+        _user_multiple = std::max(1, multiple);
+        this->update_output_multiple();
+    }
+
+    void set_min_noutput_items(const int min_noutput)
+    {
+        if (min_noutput > 0 && _max_noutput > 0 && _max_noutput < min_noutput)
+        {
+            throw std::invalid_argument("block: min_noutput_items is above max_noutput_items");
+        }
+        _min_noutput = min_noutput;
+        this->update_output_multiple();
+    }
+
+    int min_noutput_items(void) const
+    {
+        return _min_noutput;
+    }
+
+    void set_max_noutput_items(const int max_noutput)
+    {
+        if (max_noutput > 0 && _min_noutput > 0 && max_noutput < _min_noutput)
+        {
+            throw std::invalid_argument("block: max_noutput_items is below min_noutput_items");
+        }
+        _max_noutput = max_noutput;
+    }
+
+    int max_noutput_items(void) const
+    {
+        return _max_noutput;
+    }
+
     void set_auto_consume(const bool automatic)
     {
         _automatic = automatic;
@@ -321,7 +678,10 @@ public:
         uint64_t abs_start,
         uint64_t abs_end
     ){
-        return this->get_tags_in_range(tags, which_input, abs_start, abs_end);
+        tags.clear();
+        tag_index *index = this->indexed(which_input, abs_start, abs_end);
+        if (index == NULL) return this->get_tags_in_range(tags, which_input, abs_start, abs_end);
+        index->get(tags, abs_start, abs_end);
     }
 
     void public_get_tags_in_range(
@@ -331,15 +691,107 @@ public:
         uint64_t abs_end,
         const pmt::pmt_t &key
     ){
-        return this->get_tags_in_range(tags, which_input, abs_start, abs_end, key);
+        tags.clear();
+        tag_index *index = this->indexed(which_input, abs_start, abs_end);
+        if (index == NULL) return this->get_tags_in_range(tags, which_input, abs_start, abs_end, key);
+        index->get(tags, abs_start, abs_end, key);
     }
 
+    const thread_sched *sched;
+    boost::atomic<uint64_t> work_calls;
+    boost::atomic<long long> work_ticks_total;
+    boost::atomic<long long> work_ticks_max;
+
 private:
+    /*!
+     * Get the tag index of an input when it can serve the range,
+     * filling it with the tags of the whole work window once
+     * work has made enough queries on the input to pay for it.
+     * Ranges outside of the window (history, or past the available items)
+     * go to the core, since their tags are either dropped or not there yet.
+     */
+    tag_index *indexed(const unsigned int which_input, const uint64_t abs_start, const uint64_t abs_end)
+    {
+        if (which_input >= _tag_index.size()) return NULL;
+        tag_index &index = _tag_index[which_input];
+        if (abs_start < index.begin() || abs_end > _window_end[which_input]) return NULL;
+        if (abs_end > index.end())
+        {
+            if (++_tag_queries[which_input] <= TAG_INDEX_MIN_QUERIES) return NULL;
+            this->get_tags_in_range(_fill_tags, which_input, index.end(), _window_end[which_input]);
+            index.fill(_fill_tags, _window_end[which_input]);
+            _fill_tags.clear(); //resets PMT refs
+        }
+        return &index;
+    }
+
+    //the scheduler never offers fewer items than the output multiple,
+    //so the minimum is enforced by rounding it up to the base multiple:
+    //the user's multiple, and the interpolation for an exact rate
+    void update_output_multiple(void)
+    {
+        int base = _user_multiple;
+        if (_interp > 1) base = base/mygcd(base, _interp)*_interp;
+        _base_multiple = base;
+        int multiple = base;
+        if (_min_noutput > multiple)
+        {
+            multiple *= (_min_noutput + base - 1)/base;
+        }
+        gr_block::set_output_multiple(multiple);
+    }
+
+    //the inputs to consume for r outputs, an exact rate carries
+    //the fraction of an input over to the next call in _rate_phase
+    int ninput_consumed(const int r)
+    {
+        if (_interp == 0) return mylround(r/this->relative_rate());
+        const long long total = (long long)(r)*_decim + _rate_phase;
+        _rate_phase = int(total % _interp);
+        return int(total/_interp);
+    }
+
+    //once every input is done, the outputs that the rest of the input makes
+    //when that is less than the minimum, 0 otherwise, in whole base multiples
+    int tail_noutput(void)
+    {
+        const int multiple = this->output_multiple();
+        gr_block_detail_sptr d = this->detail();
+        if (multiple == _base_multiple || !d || d->ninputs() == 0) return 0;
+        int tail = multiple;
+        for (unsigned i = 0; i < d->ninputs(); i++)
+        {
+            if (!d->input(i)->done()) return 0;
+            tail = std::min(tail, fixed_rate_ninput_to_noutput(d->input(i)->items_available()));
+        }
+        return (tail < multiple)? tail - tail % _base_multiple : 0;
+    }
+
+    //clip to the maximum, keeping a multiple of the output multiple
+    int clip_noutput(const int noutput_items) const
+    {
+        if (_max_noutput <= 0 || noutput_items <= _max_noutput) return noutput_items;
+        const int multiple = this->output_multiple();
+        return std::max(multiple, _max_noutput - _max_noutput % multiple);
+    }
+
+
     block *_parent;
     std::vector<boost::shared_ptr<msg_sourcer> > *_sourcers;
     bool _automatic;
     block::InputItems _input_items;
     block::OutputItems _output_items;
+    int _user_multiple;
+    int _base_multiple; //the output multiple without the minimum
+    int _min_noutput;
+    int _max_noutput;
+    int _interp; //0 when the rate is not rational
+    int _decim;
+    int _rate_phase;
+    std::vector<tag_index> _tag_index;
+    std::vector<size_t> _tag_queries;
+    std::vector<uint64_t> _window_end;
+    std::vector<gr_tag_t> _fill_tags;
 };
 
 /***********************************************************************
@@ -355,7 +807,12 @@ struct block::impl
     std::vector<boost::shared_ptr<msg_sinker> > sinkers;
     std::vector<boost::shared_ptr<msg_sourcer> > sourcers;
     gr_null_sink_sptr null_sink;
-    MyQueue<gr_tag_t> queue;
+    msg_inbox<gr_tag_t> queue;
+    thread_sched sched;
+    bool inplace;
+    boost::atomic<size_t> work_split;
+    boost::atomic<uint64_t> msgs_posted;
+    boost::atomic<uint64_t> msgs_popped;
 };
 
 static gr_io_signature_sptr extend_sig(gr_io_signature_sptr sig, const size_t num){
@@ -388,6 +845,10 @@ block::block(
     )
 {
     _impl = boost::make_shared<impl>();
+    _impl->inplace = false;
+    _impl->work_split.store(0);
+    _impl->msgs_posted.store(0);
+    _impl->msgs_popped.store(0);
     if (in_sig->max_streams() == 0 && out_sig->max_streams() == 0)
     {
         //connect master block in case it has no IO
@@ -401,8 +862,11 @@ block::block(
         _impl->master = boost::make_shared<master_block>(name, in_sig, out_sig, this, &_impl->sourcers);
     }
 
+    _impl->master->sched = &_impl->sched;
     this->set_auto_consume(true);
     this->set_relative_rate(1.0);
+    trace::register_name(_impl->master->unique_id(), name);
+    _impl->queue.set_notify_hook(boost::bind(&master_block::notify_input, _impl->master.get()));
 
     //connect internal sink ports
     for (size_t i = 0; i < size_t(in_sig->max_streams()); i++)
@@ -417,11 +881,13 @@ block::block(
     }
 
     //connect sinker to upper ports
+    _impl->queue.resize(msg_sig.num_inputs);
     for (size_t i = 0; i < msg_sig.num_inputs; i++)
     {
         _impl->sinkers.push_back(boost::make_shared<msg_sinker>());
-        _impl->sinkers.back()->queue = &_impl->queue;
+        _impl->sinkers.back()->port = &_impl->queue.port(i);
         _impl->sinkers.back()->index = i;
+        _impl->sinkers.back()->sched = &_impl->sched;
         this->connect(this->self(), i+in_sig->max_streams(), _impl->sinkers.back(), 0);
     }
 
@@ -429,6 +895,7 @@ block::block(
     for (size_t i = 0; i < msg_sig.num_outputs; i++)
     {
         _impl->sourcers.push_back(boost::make_shared<msg_sourcer>());
+        _impl->sourcers.back()->sched = &_impl->sched;
         this->connect(_impl->sourcers.back(), 0, this->self(), i+out_sig->max_streams());
     }
 }
@@ -444,6 +911,16 @@ void block::set_auto_consume(const bool automatic)
     _impl->master->set_auto_consume(automatic);
 }
 
+void block::set_inplace(const bool inplace)
+{
+    _impl->inplace = inplace;
+}
+
+bool block::inplace(void) const
+{
+    return _impl->inplace;
+}
+
 /*******************************************************************
  * Basic routines from basic block
  ******************************************************************/
@@ -470,7 +947,7 @@ void block::set_history(unsigned history)
 
 void block::set_output_multiple(int multiple)
 {
-    return _impl->master->set_output_multiple(multiple);
+    return _impl->master->set_user_output_multiple(multiple);
 }
 
 int block::output_multiple(void) const
@@ -478,6 +955,26 @@ int block::output_multiple(void) const
     return _impl->master->output_multiple();
 }
 
+void block::set_min_noutput_items(int min_noutput)
+{
+    return _impl->master->set_min_noutput_items(min_noutput);
+}
+
+int block::min_noutput_items(void) const
+{
+    return _impl->master->min_noutput_items();
+}
+
+void block::set_max_noutput_items(int max_noutput)
+{
+    return _impl->master->set_max_noutput_items(max_noutput);
+}
+
+int block::max_noutput_items(void) const
+{
+    return _impl->master->max_noutput_items();
+}
+
 void block::consume(int which_input, int how_many_items)
 {
     return _impl->master->consume(which_input, how_many_items);
@@ -495,11 +992,31 @@ void block::produce(int which_output, int how_many_items)
 
 void block::set_relative_rate(double relative_rate)
 {
+    //integer interpolation and decimation get the exact bookkeeping,
+    //a rate of 0 or one that does not fit an int is left inexact
+    const double max_int = double(std::numeric_limits<int>::max());
+    if (relative_rate > 0.0 && relative_rate < max_int && 1.0/relative_rate < max_int)
+    {
+        const int interp = mylround(relative_rate);
+        if (interp >= 1 && double(interp) == relative_rate) return this->set_rate(interp, 1);
+        const int decim = mylround(1.0/relative_rate);
+        if (decim >= 1 && 1.0/decim == relative_rate) return this->set_rate(1, decim);
+    }
+
     if (int(relative_rate) > 1)
     {
         this->set_output_multiple(int(relative_rate));
     }
-    return _impl->master->set_relative_rate(relative_rate);
+    return _impl->master->set_inexact_rate(relative_rate);
+}
+
+void block::set_rate(const int interp, const int decim)
+{
+    if (interp < 1 || decim < 1)
+    {
+        throw std::invalid_argument("block::set_rate: interp and decim must be positive");
+    }
+    return _impl->master->set_rate(interp, decim);
 }
 
 double block::relative_rate(void) const
@@ -572,37 +1089,167 @@ void block::get_tags_in_range(
 
 bool block::check_msg_queue(void)
 {
-    return _impl->queue.ready();
+    return !_impl->queue.empty();
 }
 
 gr_tag_t block::pop_msg_queue(void)
 {
-    return _impl->queue.pop();
+    trace::scope trace_scope(trace::EVENT_POP_MSG, this->unique_id());
+    gr_tag_t msg;
+    if (_impl->queue.pop(msg)) _impl->msgs_popped.fetch_add(1, boost::memory_order_relaxed);
+    return msg;
+}
+
+bool block::pop_msg_queue(gr_tag_t &msg, const double timeout)
+{
+    trace::scope trace_scope(trace::EVENT_POP_MSG, this->unique_id());
+    if (!_impl->queue.pop(msg, timeout)) return false;
+    _impl->msgs_popped.fetch_add(1, boost::memory_order_relaxed);
+    return true;
+}
+
+bool block::wait_msg_or_input(const double timeout)
+{
+    return _impl->master->wait_msg_or_input(_impl->queue, timeout);
+}
+
+size_t block::pop_msg_queue_batch(
+    std::vector<gr_tag_t> &msgs,
+    const size_t max,
+    const double timeout
+){
+    trace::scope trace_scope(trace::EVENT_POP_MSG, this->unique_id());
+    const size_t n = _impl->queue.pop_batch(msgs, max, timeout);
+    _impl->msgs_popped.fetch_add(n, boost::memory_order_relaxed);
+    return n;
+}
+
+void block::set_msg_queue_capacity(
+    const size_t port,
+    const size_t capacity,
+    const msg_overflow_policy policy
+){
+    msg_port<gr_tag_t>::overflow_policy port_policy = msg_port<gr_tag_t>::OVERFLOW_BLOCK;
+    if (policy == MSG_OVERFLOW_DROP_NEWEST) port_policy = msg_port<gr_tag_t>::OVERFLOW_DROP_NEWEST;
+    if (policy == MSG_OVERFLOW_DROP_OLDEST) port_policy = msg_port<gr_tag_t>::OVERFLOW_DROP_OLDEST;
+    return _impl->queue.port(port).configure(capacity, port_policy);
+}
+
+size_t block::msg_queue_dropped(const size_t port)
+{
+    return _impl->queue.port(port).dropped();
+}
+
+void block::post_msg(const size_t port, const gr_tag_t &msg, const msg_priority priority)
+{
+    trace::scope trace_scope(trace::EVENT_POST_MSG, this->unique_id());
+    _impl->msgs_posted.fetch_add(1, boost::memory_order_relaxed);
+    msg_port_priority port_priority = msg_port<gr_tag_t>::PRIORITY_BULK;
+    if (priority == MSG_PRIORITY_CONTROL) port_priority = msg_port<gr_tag_t>::PRIORITY_CONTROL;
+    return _impl->sourcers.at(port)->post_msg(msg, port_priority);
 }
 
-void block::post_msg(const size_t port, const gr_tag_t &msg)
+void block::post_msgs(const size_t port, const std::vector<gr_tag_t> &msgs)
 {
-    return _impl->sourcers.at(port)->post_msg(msg);
+    trace::scope trace_scope(trace::EVENT_POST_MSG, this->unique_id());
+    _impl->msgs_posted.fetch_add(msgs.size(), boost::memory_order_relaxed);
+    return _impl->sourcers.at(port)->post_msgs(msgs);
 }
 
 void block::post_msg(
     const size_t port,
     const pmt::pmt_t &key,
     const pmt::pmt_t &value,
-    const pmt::pmt_t &srcid
+    const pmt::pmt_t &srcid,
+    const msg_priority priority
 ){
     gr_tag_t tag;
     tag.offset = 0; //not used
     tag.key = key;
     tag.value = value;
     tag.srcid = srcid;
-    this->post_msg(port, tag);
+    this->post_msg(port, tag, priority);
+}
+
+/*******************************************************************
+ * Performance monitoring
+ ******************************************************************/
+
+block_perf_counters block::perf_counters(void)
+{
+    static const double ticks_per_sec = perf_ticks_per_sec();
+    const master_block &master = *_impl->master;
+
+    block_perf_counters counters;
+    counters.work_calls = master.work_calls.load(boost::memory_order_relaxed);
+    counters.work_time_total = master.work_ticks_total.load(boost::memory_order_relaxed)/ticks_per_sec;
+    counters.work_time_max = master.work_ticks_max.load(boost::memory_order_relaxed)/ticks_per_sec;
+    counters.msg_queue_high_water = _impl->queue.high_water();
+    counters.msgs_posted = _impl->msgs_posted.load(boost::memory_order_relaxed);
+    counters.msgs_popped = _impl->msgs_popped.load(boost::memory_order_relaxed);
+
+    //item counts live in the block detail, which only exists in a flow graph
+    if (_impl->master->detail())
+    {
+        const size_t num_outputs = _impl->null_sink? 0 : _impl->master->detail()->noutputs();
+        for (size_t i = 0; i < _impl->master->detail()->ninputs(); i++)
+        {
+            counters.items_consumed.push_back(_impl->master->nitems_read(i));
+        }
+        for (size_t i = 0; i < num_outputs; i++)
+        {
+            counters.items_produced.push_back(_impl->master->nitems_written(i));
+        }
+    }
+    return counters;
+}
+
+void block::set_tracing(const bool enable)
+{
+    trace::set_enabled(enable);
+}
+
+void block::write_trace(const std::string &path)
+{
+    trace::write_json(path);
+}
+
+void block::clear_trace(void)
+{
+    trace::clear();
 }
 
 /*******************************************************************
  * Work related routines from basic block
  ******************************************************************/
 
+void block::set_processor_affinity(const std::vector<int> &cpus)
+{
+    _impl->sched.affinity = cpus;
+}
+
+std::vector<int> block::processor_affinity(void) const
+{
+    return _impl->sched.affinity;
+}
+
+void block::set_thread_priority(const double priority, const bool realtime)
+{
+    _impl->sched.priority = priority;
+    _impl->sched.realtime = realtime;
+    _impl->sched.has_priority = true;
+}
+
+void block::set_work_split(const size_t min_items)
+{
+    _impl->work_split.store(min_items, boost::memory_order_relaxed);
+}
+
+size_t block::work_split(void) const
+{
+    return _impl->work_split.load(boost::memory_order_relaxed);
+}
+
 bool block::start(void)
 {
     return true;
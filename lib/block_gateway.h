@@ -33,6 +33,17 @@ enum tag_propagation_policy_t {
     TPP_ONE_TO_ONE = 2
 };
 
+enum msg_overflow_policy_t {
+    MSG_OVERFLOW_BLOCK = 0,
+    MSG_OVERFLOW_DROP_NEWEST = 1,
+    MSG_OVERFLOW_DROP_OLDEST = 2
+};
+
+enum msg_priority_t {
+    MSG_PRIORITY_BULK = 0,
+    MSG_PRIORITY_CONTROL = 1
+};
+
 /*!
  * Shared message structure between python and gateway.
  * Each action type represents a scheduler-called function.
@@ -125,6 +136,22 @@ public:
         return gnuradio::block::output_multiple();
     }
 
+    void gr_block__set_min_noutput_items(int min_noutput){
+        return gnuradio::block::set_min_noutput_items(min_noutput);
+    }
+
+    int gr_block__min_noutput_items(void) const{
+        return gnuradio::block::min_noutput_items();
+    }
+
+    void gr_block__set_max_noutput_items(int max_noutput){
+        return gnuradio::block::set_max_noutput_items(max_noutput);
+    }
+
+    int gr_block__max_noutput_items(void) const{
+        return gnuradio::block::max_noutput_items();
+    }
+
     void gr_block__consume(int which_input, int how_many_items){
         return gnuradio::block::consume(which_input, how_many_items);
     }
@@ -145,6 +172,10 @@ public:
         return gnuradio::block::relative_rate();
     }
 
+    void gr_block__set_rate(const int interp, const int decim){
+        return gnuradio::block::set_rate(interp, decim);
+    }
+
     uint64_t gr_block__nitems_read(unsigned int which_input){
         return gnuradio::block::nitems_read(which_input);
     }
@@ -198,6 +229,22 @@ public:
         return tags;
     }
 
+    gnuradio::block_perf_counters gr_block__perf_counters(void){
+        return gnuradio::block::perf_counters();
+    }
+
+    void gr_block__set_processor_affinity(const std::vector<int> &cpus){
+        return gnuradio::block::set_processor_affinity(cpus);
+    }
+
+    std::vector<int> gr_block__processor_affinity(void) const{
+        return gnuradio::block::processor_affinity();
+    }
+
+    void gr_block__set_thread_priority(const double priority, const bool realtime = true){
+        return gnuradio::block::set_thread_priority(priority, realtime);
+    }
+
     bool gr_block__check_msg_queue(void){
         return gnuradio::block::check_msg_queue();
     }
@@ -206,17 +253,51 @@ public:
         return gnuradio::block::pop_msg_queue();
     }
 
-    void gr_block__post_msg(const size_t port, const gr_tag_t &msg){
-        return gnuradio::block::post_msg(port, msg);
+    bool gr_block__wait_msg_or_input(const double timeout){
+        return gnuradio::block::wait_msg_or_input(timeout);
+    }
+
+    std::vector<gr_tag_t> gr_block__pop_msg_queue_batch(const size_t max, const double timeout=-1.0){
+        std::vector<gr_tag_t> msgs;
+        gnuradio::block::pop_msg_queue_batch(msgs, max, timeout);
+        return msgs;
+    }
+
+    void gr_block__set_msg_queue_capacity(
+        const size_t port,
+        const size_t capacity,
+        msg_overflow_policy_t policy=::MSG_OVERFLOW_BLOCK
+    ){
+        return gnuradio::block::set_msg_queue_capacity(
+            port, capacity, (gnuradio::block::msg_overflow_policy)policy);
+    }
+
+    size_t gr_block__msg_queue_dropped(const size_t port){
+        return gnuradio::block::msg_queue_dropped(port);
+    }
+
+    void gr_block__post_msg(
+        const size_t port,
+        const gr_tag_t &msg,
+        msg_priority_t priority=::MSG_PRIORITY_BULK
+    ){
+        return gnuradio::block::post_msg(
+            port, msg, (gnuradio::block::msg_priority)priority);
     }
 
     void gr_block__post_msg(
         const size_t port,
         const pmt::pmt_t &key,
         const pmt::pmt_t &value,
-        const pmt::pmt_t &srcid=pmt::PMT_F
+        const pmt::pmt_t &srcid=pmt::PMT_F,
+        msg_priority_t priority=::MSG_PRIORITY_BULK
     ){
-        return gnuradio::block::post_msg(port, key, value, srcid);
+        return gnuradio::block::post_msg(
+            port, key, value, srcid, (gnuradio::block::msg_priority)priority);
+    }
+
+    void gr_block__post_msgs(const size_t port, const std::vector<gr_tag_t> &msgs){
+        return gnuradio::block::post_msgs(port, msgs);
     }
 
 };
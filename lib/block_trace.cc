@@ -0,0 +1,237 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "block_trace.h"
+#include <boost/foreach.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <map>
+
+using namespace gnuradio;
+
+boost::atomic<bool> trace::_enabled(false);
+
+/***********************************************************************
+ * The per-thread event ring
+ *
+ * Only the owning thread writes into a ring, so recording an event is
+ * a store of the event and a release store of the count; no locks.
+ * The dump reads up to the count it observes, and when the ring wraps
+ * the oldest events are overwritten.
+ *
+ * A ring outlives its thread so it can be dumped after the flow graph,
+ * but an exiting thread returns it to a free list for the next thread,
+ * so restarting a flow graph does not grow the number of rings.
+ **********************************************************************/
+static const size_t RING_SIZE = 1 << 14; //events per thread
+
+struct trace_event
+{
+    long long begin;
+    long long end;
+    long id;
+    trace::event_type type;
+};
+
+struct trace_ring
+{
+    trace_ring(const size_t tid):
+        tid(tid), events(new trace_event[RING_SIZE]), count(0), start(0)
+    {
+        //NOP
+    }
+
+    const size_t tid;
+    boost::scoped_array<trace_event> events;
+    boost::atomic<size_t> count;
+    size_t start; //events before this were cleared, guarded by the registry mutex
+};
+
+//the registry is never destroyed, threads may return rings after static destruction
+static boost::mutex &registry_mutex(void)
+{
+    static boost::mutex *mutex = new boost::mutex();
+    return *mutex;
+}
+
+static std::vector<boost::shared_ptr<trace_ring> > &registry_rings(void)
+{
+    static std::vector<boost::shared_ptr<trace_ring> > *rings = new std::vector<boost::shared_ptr<trace_ring> >();
+    return *rings;
+}
+
+static std::vector<trace_ring *> &registry_free_rings(void)
+{
+    static std::vector<trace_ring *> *rings = new std::vector<trace_ring *>();
+    return *rings;
+}
+
+//called when a recording thread exits
+static void return_ring(trace_ring *ring)
+{
+    boost::mutex::scoped_lock lock(registry_mutex());
+    registry_free_rings().push_back(ring);
+}
+
+static boost::thread_specific_ptr<trace_ring> thread_ring(&return_ring);
+
+static std::map<long, std::string> &registry_names(void)
+{
+    static std::map<long, std::string> names;
+    return names;
+}
+
+static trace_ring *make_thread_ring(void)
+{
+    boost::mutex::scoped_lock lock(registry_mutex());
+    trace_ring *ring = NULL;
+    if (!registry_free_rings().empty())
+    {
+        ring = registry_free_rings().back();
+        registry_free_rings().pop_back();
+    }
+    else
+    {
+        static size_t next_tid = 0;
+        boost::shared_ptr<trace_ring> new_ring(new trace_ring(next_tid++));
+        registry_rings().push_back(new_ring);
+        ring = new_ring.get();
+    }
+    thread_ring.reset(ring);
+    return ring;
+}
+
+/***********************************************************************
+ * Recording
+ **********************************************************************/
+void trace::record(const event_type type, const long id, const long long begin, const long long end)
+{
+    trace_ring *ring = thread_ring.get();
+    if (ring == NULL) ring = make_thread_ring();
+
+    const size_t n = ring->count.load(boost::memory_order_relaxed);
+    trace_event &event = ring->events[n % RING_SIZE];
+    event.begin = begin;
+    event.end = end;
+    event.id = id;
+    event.type = type;
+    ring->count.store(n + 1, boost::memory_order_release);
+}
+
+void trace::register_name(const long id, const std::string &name)
+{
+    boost::mutex::scoped_lock lock(registry_mutex());
+    registry_names()[id] = name;
+}
+
+void trace::set_enabled(const bool enable)
+{
+    _enabled.store(enable, boost::memory_order_relaxed);
+}
+
+void trace::clear(void)
+{
+    boost::mutex::scoped_lock lock(registry_mutex());
+
+    //rings of exited threads are released, the rest skip their old events
+    std::vector<boost::shared_ptr<trace_ring> > &rings = registry_rings();
+    std::vector<trace_ring *> &free_rings = registry_free_rings();
+    for (size_t i = 0; i < rings.size();)
+    {
+        if (std::find(free_rings.begin(), free_rings.end(), rings[i].get()) != free_rings.end())
+        {
+            rings.erase(rings.begin() + i);
+        }
+        else
+        {
+            rings[i]->start = rings[i]->count.load(boost::memory_order_acquire);
+            i++;
+        }
+    }
+    free_rings.clear();
+}
+
+/***********************************************************************
+ * Chrome trace event format export
+ **********************************************************************/
+static const char *event_type_name(const trace::event_type type)
+{
+    switch (type)
+    {
+    case trace::EVENT_WORK: return "work";
+    case trace::EVENT_POST_MSG: return "post_msg";
+    case trace::EVENT_POP_MSG: return "pop_msg_queue";
+    }
+    return "unknown";
+}
+
+static std::string json_escape(const std::string &in)
+{
+    std::string out;
+    BOOST_FOREACH(const char ch, in)
+    {
+        if (ch == '"' || ch == '\\') out += '\\';
+        if (ch >= 0 && ch < ' ') continue;
+        out += ch;
+    }
+    return out;
+}
+
+void trace::write_json(const std::string &path)
+{
+    std::ofstream out(path.c_str());
+    if (!out) throw std::runtime_error("trace: cannot open " + path);
+
+    boost::mutex::scoped_lock lock(registry_mutex());
+    const double us_per_tick = 1e6/perf_ticks_per_sec();
+    out.precision(3);
+    out << std::fixed;
+    out << "{\"traceEvents\":[" << std::endl;
+    bool first = true;
+    BOOST_FOREACH(const boost::shared_ptr<trace_ring> &ring, registry_rings())
+    {
+        const size_t count = ring->count.load(boost::memory_order_acquire);
+        const size_t start = std::max(ring->start, (count > RING_SIZE)? count - RING_SIZE : 0);
+        for (size_t i = start; i < count; i++)
+        {
+            const trace_event event = ring->events[i % RING_SIZE];
+            std::map<long, std::string>::const_iterator it = registry_names().find(event.id);
+            const std::string name = (it == registry_names().end())? "block" : it->second;
+            if (!first) out << "," << std::endl;
+            first = false;
+            out << "{\"name\":\"" << json_escape(name) << " " << event_type_name(event.type) << "\","
+                << "\"cat\":\"" << event_type_name(event.type) << "\","
+                << "\"ph\":\"X\","
+                << "\"ts\":" << event.begin*us_per_tick << ","
+                << "\"dur\":" << (event.end - event.begin)*us_per_tick << ","
+                << "\"pid\":1,"
+                << "\"tid\":" << ring->tid << ","
+                << "\"args\":{\"id\":" << event.id << "}}";
+        }
+    }
+    out << std::endl << "]}" << std::endl;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_BLOCK_TRACE_H
+#define INCLUDED_GR_EXTRAS_BLOCK_TRACE_H
+
+#include "perf_ticks.h"
+#include <boost/atomic.hpp>
+#include <string>
+
+namespace gnuradio{ namespace trace{
+
+//! The kinds of events recorded by the tracer
+enum event_type
+{
+    EVENT_WORK,
+    EVENT_POST_MSG,
+    EVENT_POP_MSG,
+};
+
+extern boost::atomic<bool> _enabled;
+
+//! Is the tracer recording? One relaxed load, check before taking ticks
+static inline bool enabled(void)
+{
+    return _enabled.load(boost::memory_order_relaxed);
+}
+
+//! Record a complete event into the ring of the calling thread
+void record(const event_type type, const long id, const long long begin, const long long end);
+
+//! Associate a block unique id with a name for the trace file
+void register_name(const long id, const std::string &name);
+
+void set_enabled(const bool enable);
+
+//! Discard the recorded events, and the rings of threads that have exited
+void clear(void);
+
+//! Write the recorded events to a Chrome/Perfetto JSON trace file
+void write_json(const std::string &path);
+
+//! Record an event for the lifetime of this object
+class scope
+{
+public:
+    scope(const event_type type, const long id):
+        _type(type), _id(id), _begin(enabled()? perf_ticks() : -1)
+    {
+        //NOP
+    }
+
+    ~scope(void)
+    {
+        if (_begin >= 0) record(_type, _id, _begin, perf_ticks());
+    }
+
+private:
+    const event_type _type;
+    const long _id;
+    const long long _begin;
+};
+
+}} //namespace gnuradio::trace
+
+#endif /* INCLUDED_GR_EXTRAS_BLOCK_TRACE_H */
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gnuradio/extras/convert.h>
+#include <gr_io_signature.h>
+#include <gruel/thread.h>
+#include <boost/atomic.hpp>
+#include "op_kernels.h"
+
+using namespace gnuradio::extras;
+
+/***********************************************************************
+ * Generic converter implementation - calls the SIMD kernels
+ **********************************************************************/
+template <typename in_type, typename out_type>
+class convert_generic : public convert{
+public:
+    convert_generic(const double scale, const size_t vlen):
+        block(
+            "convert generic",
+            gr_make_io_signature (1, 1, sizeof(in_type)*vlen),
+            gr_make_io_signature (1, 1, sizeof(out_type)*vlen)
+        ),
+        _vlen(vlen)
+    {
+        this->set_scale(scale);
+    }
+
+    void set_scale(const double scale){
+        gruel::scoped_lock l(_setter_mutex);
+        _original_scale = scale;
+        _scale.store(float(scale), boost::memory_order_relaxed);
+    }
+
+    double get_scale(void){
+        gruel::scoped_lock l(_setter_mutex);
+        return _original_scale;
+    }
+
+    int work(
+        const InputItems &input_items,
+        const OutputItems &output_items
+    ){
+        //complex items are converted as their interleaved lanes
+        const size_t n_nums = output_items[0].size() * _vlen;
+        gnuradio::kernels::convert(
+            output_items[0].cast<out_type *>(),
+            input_items[0].cast<const in_type *>(),
+            _scale.load(boost::memory_order_relaxed), n_nums
+        );
+        return output_items[0].size();
+    }
+
+private:
+    const size_t _vlen;
+    boost::atomic<float> _scale;
+    gruel::mutex _setter_mutex;
+    double _original_scale;
+};
+
+/***********************************************************************
+ * factory function
+ **********************************************************************/
+#define make_factory_function(suffix, in_type, out_type, lanes) \
+    convert::sptr convert::make_ ## suffix(const double scale, const size_t vlen){ \
+    return gnuradio::get_initial_sptr(new convert_generic<in_type, out_type>(scale, lanes*vlen)); \
+}
+
+make_factory_function(sc32_fc32, int32_t, float, 2)
+make_factory_function(sc16_fc32, int16_t, float, 2)
+make_factory_function(sc8_fc32, int8_t, float, 2)
+make_factory_function(fc32_sc32, float, int32_t, 2)
+make_factory_function(fc32_sc16, float, int16_t, 2)
+make_factory_function(fc32_sc8, float, int8_t, 2)
+make_factory_function(s32_f32, int32_t, float, 1)
+make_factory_function(s16_f32, int16_t, float, 1)
+make_factory_function(s8_f32, int8_t, float, 1)
+make_factory_function(f32_s32, float, int32_t, 1)
+make_factory_function(f32_s16, float, int16_t, 1)
+make_factory_function(f32_s8, float, int8_t, 1)
@@ -22,7 +22,7 @@
 #include <gnuradio/extras/delay.h>
 #include <gr_io_signature.h>
 #include <cstring> //memcpy
-#include <gruel/thread.h>
+#include <boost/atomic.hpp>
 
 using namespace gnuradio::extras;
 
@@ -44,8 +44,7 @@ public:
     }
 
     void set_delay(const int nitems){
-        gruel::scoped_lock l(_delay_mutex);
-        _delay_items = -nitems;
+        _delay_items.store(-nitems, boost::memory_order_relaxed);
     }
 
     void forecast(
@@ -63,9 +62,9 @@ public:
         const InputItems &input_items,
         const OutputItems &output_items
     ){
-        gruel::scoped_lock l(_delay_mutex);
+        const int delay_items = _delay_items.load(boost::memory_order_relaxed);
         size_t noutput_items = output_items[0].size();
-        const int delta = int64_t(nitems_read(0)) - int64_t(nitems_written(0)) - _delay_items;
+        const int delta = int64_t(nitems_read(0)) - int64_t(nitems_written(0)) - delay_items;
 
         //consume but not produce (drops samples)
         if (delta < 0){
@@ -88,9 +87,8 @@ public:
     }
 
 private:
-    int _delay_items;
+    boost::atomic<int> _delay_items;
     const size_t _itemsize;
-    gruel::mutex _delay_mutex;
 };
 
 /***********************************************************************
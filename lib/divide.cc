@@ -23,12 +23,37 @@
 #include <gr_io_signature.h>
 #include <stdexcept>
 #include <complex>
-#include <volk/volk.h>
+#include <boost/atomic.hpp>
+#include "op_kernels.h"
+#include "work_pool.h"
 
 using namespace gnuradio::extras;
 
 /***********************************************************************
- * Generic divideer implementation
+ * Kernel selection, only the real float kernels have a fast mode
+ **********************************************************************/
+template <typename type>
+static void divide_items(type *out, const type *const *in, const size_t m, const size_t n, const bool){
+    gnuradio::kernels::divide(out, in, m, n);
+}
+
+static void divide_items(float *out, const float *const *in, const size_t m, const size_t n, const bool fast){
+    if (fast) gnuradio::kernels::divide_fast(out, in, m, n);
+    else gnuradio::kernels::divide(out, in, m, n);
+}
+
+template <typename type>
+static void reciprocal_items(type *out, const type *in, const size_t n, const bool){
+    gnuradio::kernels::reciprocal(out, in, n);
+}
+
+static void reciprocal_items(float *out, const float *in, const size_t n, const bool fast){
+    if (fast) gnuradio::kernels::reciprocal_fast(out, in, n);
+    else gnuradio::kernels::reciprocal(out, in, n);
+}
+
+/***********************************************************************
+ * Generic divider implementation
  **********************************************************************/
 template <typename type>
 class divide_generic : public divide{
@@ -39,9 +64,15 @@ public:
             gr_make_io_signature (num_inputs, num_inputs, sizeof(type)*vlen),
             gr_make_io_signature (1, 1, sizeof(type)*vlen)
         ),
-        _vlen(vlen)
+        _vlen(vlen),
+        _ins(num_inputs),
+        _fast(false)
     {
-        //NOP
+        this->set_inplace(true); //out[i] = f(in0[i], ...)
+    }
+
+    void set_fast_reciprocal(const bool fast){
+        _fast.store(fast, boost::memory_order_relaxed);
     }
 
     int work(
@@ -49,56 +80,50 @@ public:
         const OutputItems &output_items
     ){
         const size_t noutput_items = output_items[0].size();
+        const size_t n_nums = noutput_items * _vlen;
+        const bool fast = _fast.load(boost::memory_order_relaxed);
+        type *out = output_items[0].cast<type *>();
 
-        if(input_items.size() == 1) {
-            const size_t n_nums = noutput_items * _vlen;
-            type *out = output_items[0].cast<type *>();
-            const type *in = input_items[0].cast<const type *>();
-
-            for (size_t i = 0; i < n_nums; i++){
-                out[i] = static_cast<type>(1) / in[i];
-            }
-
+        //one input, output = 1 / input0
+        if (input_items.size() == 1){
+            reciprocal_items(out, input_items[0].cast<const type *>(), n_nums, fast);
             return noutput_items;
         }
-        else {
-            const size_t n_nums = noutput_items * _vlen;
-            type *out = output_items[0].cast<type *>();
-            const type *in0 = input_items[0].cast<const type *>();
-
-            for (size_t n = 1; n < input_items.size(); n++){
-                const type *in = input_items[n].cast<const type *>();
-                for (size_t i = 0; i < n_nums; i++){
-                    out[i] = in0[i] / in[i];
-                }
-                in0 = out; //for next input, we do output /= input
-            }
 
-            return noutput_items;
+        for (size_t n = 0; n < input_items.size(); n++){
+            _ins[n] = input_items[n].cast<const type *>();
         }
+
+        //one pass over all inputs, output = input0 / input1 / ...
+        const size_t split = this->work_split();
+        gnuradio::parallel_nary(&divide_items, out, &_ins[0], _ins.size(), n_nums, fast, split != 0 && noutput_items >= split, _chunk_ins);
+        return noutput_items;
     }
 
 private:
     const size_t _vlen;
+    std::vector<const type *> _ins;
+    std::vector<const type *> _chunk_ins;
+    boost::atomic<bool> _fast;
 };
 
 /***********************************************************************
  * factory function
  **********************************************************************/
 divide::sptr divide::make_fc32_fc32(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new divide_generic<float>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new divide_generic<std::complex<float> >(num_inputs, vlen));
 }
 
 divide::sptr divide::make_sc32_sc32(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new divide_generic<int32_t>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new divide_generic<std::complex<int32_t> >(num_inputs, vlen));
 }
 
 divide::sptr divide::make_sc16_sc16(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new divide_generic<int16_t>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new divide_generic<std::complex<int16_t> >(num_inputs, vlen));
 }
 
 divide::sptr divide::make_sc8_sc8(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new divide_generic<int8_t>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new divide_generic<std::complex<int8_t> >(num_inputs, vlen));
 }
 
 divide::sptr divide::make_f32_f32(const size_t num_inputs, const size_t vlen){
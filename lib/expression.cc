@@ -0,0 +1,372 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gnuradio/extras/expression.h>
+#include <gr_io_signature.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include "op_kernels.h"
+
+using namespace gnuradio::extras;
+
+static const size_t TILE_BYTES = 4*1024; //temporaries and input tiles stay in L1
+
+/***********************************************************************
+ * Parse the expression text into a tree
+ **********************************************************************/
+struct expr_node{
+    char op; //+ - * / for binary, 'n' negate, 'i' input, 'c' constant
+    size_t input;
+    std::complex<double> value;
+    boost::shared_ptr<expr_node> lhs, rhs;
+};
+
+typedef boost::shared_ptr<expr_node> expr_node_sptr;
+
+class expr_parser{
+public:
+    expr_parser(const std::string &text):
+        _text(text), _pos(0)
+    {
+        //NOP
+    }
+
+    expr_node_sptr parse(void){
+        expr_node_sptr node = this->parse_sum();
+        this->skip_space();
+        if (_pos != _text.size()) this->fail("unexpected character");
+        return node;
+    }
+
+private:
+    //sum := product (('+'|'-') product)*
+    expr_node_sptr parse_sum(void){
+        expr_node_sptr node = this->parse_product();
+        while (this->peek() == '+' || this->peek() == '-'){
+            const char op = _text[_pos++];
+            node = make_op(op, node, this->parse_product());
+        }
+        return node;
+    }
+
+    //product := unary (('*'|'/') unary)*
+    expr_node_sptr parse_product(void){
+        expr_node_sptr node = this->parse_unary();
+        while (this->peek() == '*' || this->peek() == '/'){
+            const char op = _text[_pos++];
+            node = make_op(op, node, this->parse_unary());
+        }
+        return node;
+    }
+
+    //unary := ('-'|'+') unary | primary
+    expr_node_sptr parse_unary(void){
+        if (this->peek() == '+'){
+            _pos++;
+            return this->parse_unary();
+        }
+        if (this->peek() == '-'){
+            _pos++;
+            return make_op('n', this->parse_unary(), expr_node_sptr());
+        }
+        return this->parse_primary();
+    }
+
+    //primary := number ['j'] | 'in' digits | '(' sum ')'
+    expr_node_sptr parse_primary(void){
+        const char c = this->peek();
+        expr_node_sptr node(new expr_node());
+        if (c == '('){
+            _pos++;
+            node = this->parse_sum();
+            if (this->peek() != ')') this->fail("missing )");
+            _pos++;
+        }
+        else if (std::isdigit(c) || c == '.'){
+            const char *begin = _text.c_str() + _pos;
+            char *end = NULL;
+            const double num = std::strtod(begin, &end);
+            if (end == begin) this->fail("bad number");
+            _pos += end - begin;
+            node->op = 'c';
+            node->value = num;
+            if (_pos < _text.size() && _text[_pos] == 'j'){
+                _pos++;
+                node->value = std::complex<double>(0, num);
+            }
+        }
+        else if (std::isalpha(c) || c == '_'){
+            const size_t begin = _pos;
+            while (_pos < _text.size() && (std::isalnum(_text[_pos]) || _text[_pos] == '_')) _pos++;
+            const std::string name = _text.substr(begin, _pos - begin);
+            if (name.size() < 3 || name.substr(0, 2) != "in" ||
+                name.find_first_not_of("0123456789", 2) != std::string::npos
+            ){
+                _pos = begin;
+                this->fail("unknown name " + name);
+            }
+            node->op = 'i';
+            node->input = boost::lexical_cast<size_t>(name.substr(2));
+        }
+        else{
+            this->fail((c == '\0')? "unexpected end" : "unexpected character");
+        }
+        return node;
+    }
+
+    static expr_node_sptr make_op(const char op, expr_node_sptr lhs, expr_node_sptr rhs){
+        expr_node_sptr node(new expr_node());
+        node->op = op;
+        node->lhs = lhs;
+        node->rhs = rhs;
+        return node;
+    }
+
+    void skip_space(void){
+        while (_pos < _text.size() && std::isspace(_text[_pos])) _pos++;
+    }
+
+    char peek(void){
+        this->skip_space();
+        return (_pos < _text.size())? _text[_pos] : '\0';
+    }
+
+    void fail(const std::string &what){
+        throw std::invalid_argument(
+            "expression: " + what + " at position " +
+            boost::lexical_cast<std::string>(_pos) + " of \"" + _text + "\""
+        );
+    }
+
+    const std::string _text;
+    size_t _pos;
+};
+
+/***********************************************************************
+ * The operations on tiles, the same kernels as the op blocks
+ **********************************************************************/
+template <typename type> struct is_complex{static const bool value = false;};
+template <typename type> struct is_complex<std::complex<type> >{static const bool value = true;};
+template <typename type> struct is_integer{static const bool value = std::numeric_limits<type>::is_integer;};
+template <typename type> struct is_integer<std::complex<type> >{static const bool value = std::numeric_limits<type>::is_integer;};
+
+template <typename type>
+static void run_op(const char op, type *out, const type *a, const type *b, const size_t n){
+    const type *ab[2] = {a, b};
+    switch (op){
+    case '+': gnuradio::kernels::add(out, a, b, n); break;
+    case '-': gnuradio::kernels::subtract(out, a, b, n); break;
+    case '*': gnuradio::kernels::multiply(out, a, b, n); break;
+    case '/': gnuradio::kernels::divide(out, ab, 2, n); break;
+    case 'n': gnuradio::kernels::negate(out, a, n); break;
+    default: std::copy(a, a + n, out); break;
+    }
+}
+
+/***********************************************************************
+ * Expression implementation
+ **********************************************************************/
+template <typename type>
+class expression_generic : public expression{
+public:
+    expression_generic(const std::string &expr, const size_t num_inputs, const size_t vlen):
+        block(
+            "expression generic",
+            gr_make_io_signature (num_inputs, num_inputs, sizeof(type)*vlen),
+            gr_make_io_signature (1, 1, sizeof(type)*vlen)
+        ),
+        _vlen(vlen),
+        _tile(std::max(size_t(1), TILE_BYTES/sizeof(type))),
+        _num_inputs(num_inputs),
+        _num_temps(0),
+        _ins(num_inputs)
+    {
+        expr_node_sptr root = expr_parser(expr).parse();
+        this->compile(root, true);
+        _temps.resize(_num_temps*_tile);
+        this->set_inplace(true); //out[i] = f(in0[i], ...)
+    }
+
+    int work(
+        const InputItems &input_items,
+        const OutputItems &output_items
+    ){
+        const size_t noutput_items = output_items[0].size();
+        const size_t n_nums = noutput_items * _vlen;
+        type *out = output_items[0].cast<type *>();
+        for (size_t n = 0; n < input_items.size(); n++){
+            _ins[n] = input_items[n].cast<const type *>();
+        }
+
+        //each tile goes through every step while it is in cache
+        for (size_t offset = 0; offset < n_nums; offset += _tile){
+            const size_t n = std::min(_tile, n_nums - offset);
+            for (size_t i = 0; i < _steps.size(); i++){
+                const step &s = _steps[i];
+                type *dst = (s.dst.kind == OUTPUT)? out + offset : &_temps[s.dst.index*_tile];
+                run_op(s.op, dst, this->resolve(s.a, offset), this->resolve(s.b, offset), n);
+            }
+        }
+        return noutput_items;
+    }
+
+private:
+    enum operand_kind {NONE, INPUT, CONSTANT, TEMP, OUTPUT};
+
+    struct operand{
+        operand(const operand_kind kind = NONE, const size_t index = 0):
+            kind(kind), index(index)
+        {
+            //NOP
+        }
+        operand_kind kind;
+        size_t index;
+    };
+
+    struct step{
+        char op;
+        operand dst, a, b;
+    };
+
+    const type *resolve(const operand &o, const size_t offset){
+        switch (o.kind){
+        case INPUT: return _ins[o.index] + offset;
+        case CONSTANT: return &_constants[o.index][0];
+        case TEMP: return &_temps[o.index*_tile];
+        default: return NULL;
+        }
+    }
+
+    //! Turn a tree into steps, constant operations are folded
+    operand compile(expr_node_sptr node, const bool root){
+        operand result;
+        if (node->op == 'i'){
+            if (node->input >= _num_inputs){
+                throw std::invalid_argument("expression: in" +
+                    boost::lexical_cast<std::string>(node->input) + " is not an input");
+            }
+            result = operand(INPUT, node->input);
+        }
+        else if (node->op == 'c'){
+            if (!is_complex<type>::value && node->value.imag() != 0){
+                throw std::invalid_argument("expression: imaginary constant for a real type");
+            }
+            if (is_integer<type>::value && (
+                node->value.real() != std::floor(node->value.real()) ||
+                node->value.imag() != std::floor(node->value.imag())
+            )){
+                throw std::invalid_argument("expression: non-integer constant for an integer type");
+            }
+            type val;
+            gr_complex_double_to_num(node->value, val);
+            result = this->make_constant(val);
+        }
+        else{
+            const operand a = this->compile(node->lhs, false);
+            const operand b = (node->rhs)? this->compile(node->rhs, false) : operand();
+            if (node->op == '/' && b.kind == CONSTANT && _constants[b.index][0] == type(0)){
+                throw std::invalid_argument("expression: division by zero");
+            }
+
+            //fold constants with the same kernels that work() uses
+            if (a.kind == CONSTANT && (b.kind == CONSTANT || b.kind == NONE)){
+                type val;
+                const type *bp = (b.kind == CONSTANT)? &_constants[b.index][0] : NULL;
+                run_op(node->op, &val, &_constants[a.index][0], bp, 1);
+                result = this->make_constant(val);
+            }
+            else{
+                this->release(a);
+                this->release(b);
+                step s;
+                s.op = node->op;
+                s.dst = root? operand(OUTPUT) : this->acquire();
+                s.a = a;
+                s.b = b;
+                _steps.push_back(s);
+                return s.dst;
+            }
+        }
+
+        //a lone input or constant still has to reach the output
+        if (root){
+            step s;
+            s.op = '=';
+            s.dst = operand(OUTPUT);
+            s.a = result;
+            _steps.push_back(s);
+        }
+        return result;
+    }
+
+    operand make_constant(const type &val){
+        _constants.push_back(std::vector<type>(_tile, val));
+        return operand(CONSTANT, _constants.size() - 1);
+    }
+
+    //temporaries are reused once a step has read them
+    operand acquire(void){
+        if (_free_temps.empty()) return operand(TEMP, _num_temps++);
+        const operand t = _free_temps.back();
+        _free_temps.pop_back();
+        return t;
+    }
+
+    void release(const operand &o){
+        if (o.kind == TEMP) _free_temps.push_back(o);
+    }
+
+    const size_t _vlen;
+    const size_t _tile;
+    const size_t _num_inputs;
+    size_t _num_temps;
+    std::vector<const type *> _ins;
+    std::vector<step> _steps;
+    std::vector<std::vector<type> > _constants;
+    std::vector<operand> _free_temps;
+    std::vector<type> _temps;
+};
+
+/***********************************************************************
+ * factory function
+ **********************************************************************/
+expression::sptr expression::make_fc32_fc32(const std::string &expr, const size_t num_inputs, const size_t vlen){
+    return gnuradio::get_initial_sptr(new expression_generic<std::complex<float> >(expr, num_inputs, vlen));
+}
+
+expression::sptr expression::make_sc16_sc16(const std::string &expr, const size_t num_inputs, const size_t vlen){
+    return gnuradio::get_initial_sptr(new expression_generic<std::complex<int16_t> >(expr, num_inputs, vlen));
+}
+
+expression::sptr expression::make_f32_f32(const std::string &expr, const size_t num_inputs, const size_t vlen){
+    return gnuradio::get_initial_sptr(new expression_generic<float>(expr, num_inputs, vlen));
+}
+
+expression::sptr expression::make_s16_s16(const std::string &expr, const size_t num_inputs, const size_t vlen){
+    return gnuradio::get_initial_sptr(new expression_generic<int16_t>(expr, num_inputs, vlen));
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gnuradio/extras/inplace_chain.h>
+#include <gr_io_signature.h>
+#include <boost/foreach.hpp>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace gnuradio::extras;
+
+typedef boost::shared_ptr<gnuradio::block> block_sptr;
+
+static const size_t TILE_BYTES = 16*1024; //in and out tiles fit in L1
+
+static size_t gcd(size_t a, size_t b){
+    while (b != 0){
+        const size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/***********************************************************************
+ * Check and cast a stage of the chain
+ **********************************************************************/
+static block_sptr to_stage(gr_basic_block_sptr basic_block){
+    block_sptr stage = boost::dynamic_pointer_cast<gnuradio::block>(basic_block);
+    if (!stage){
+        throw std::invalid_argument("inplace_chain: " + basic_block->name() + " is not an extras block");
+    }
+    if (!stage->inplace()){
+        throw std::invalid_argument("inplace_chain: " + stage->name() + " does not work in place");
+    }
+    if (stage->input_signature()->max_streams() != 1 || stage->output_signature()->max_streams() != 1){
+        throw std::invalid_argument("inplace_chain: " + stage->name() + " needs exactly one input and output");
+    }
+    if (stage->input_signature()->sizeof_stream_item(0) != stage->output_signature()->sizeof_stream_item(0)){
+        throw std::invalid_argument("inplace_chain: " + stage->name() + " changes the item size");
+    }
+    if (stage->relative_rate() != 1.0){
+        throw std::invalid_argument("inplace_chain: " + stage->name() + " is not a sync block");
+    }
+    //stages are never in a flow graph, so they have no buffers to look back into
+    if (stage->history() > 1){
+        throw std::invalid_argument("inplace_chain: " + stage->name() + " needs history");
+    }
+    return stage;
+}
+
+/***********************************************************************
+ * In-place chain implementation
+ **********************************************************************/
+class inplace_chain_impl : public inplace_chain{
+public:
+    inplace_chain_impl(const std::vector<block_sptr> &stages, const size_t itemsize):
+        block(
+            "inplace chain",
+            gr_make_io_signature (1, 1, itemsize),
+            gr_make_io_signature (1, 1, itemsize)
+        ),
+        _stages(stages),
+        _itemsize(itemsize),
+        _in(1), _out(1)
+    {
+        //keep the alignment that each stage asks of its buffers
+        size_t multiple = 1;
+        BOOST_FOREACH(const block_sptr &stage, _stages){
+            const size_t m = size_t(stage->output_multiple());
+            multiple = multiple/gcd(multiple, m)*m;
+        }
+        this->set_output_multiple(int(multiple));
+        _tile = std::max(size_t(1), TILE_BYTES/itemsize);
+        _tile = std::max(multiple, _tile - _tile % multiple);
+        this->set_inplace(true);
+    }
+
+    bool start(void){
+        BOOST_FOREACH(const block_sptr &stage, _stages){
+            if (!stage->start()) return false;
+        }
+        return true;
+    }
+
+    bool stop(void){
+        bool ok = true;
+        BOOST_FOREACH(const block_sptr &stage, _stages){
+            ok = stage->stop() && ok;
+        }
+        return ok;
+    }
+
+    int work(
+        const InputItems &input_items,
+        const OutputItems &output_items
+    ){
+        const size_t noutput_items = output_items[0].size();
+        const char *in = input_items[0].cast<const char *>();
+        char *out = output_items[0].cast<char *>();
+
+        //each tile goes through every stage while it is in cache
+        for (size_t offset = 0; offset < noutput_items; offset += _tile){
+            const size_t n = std::min(_tile, noutput_items - offset);
+            _in[0]._mem = in + offset*_itemsize;
+            _in[0]._len = n;
+            _out[0]._mem = out + offset*_itemsize;
+            _out[0]._len = n;
+            for (size_t i = 0; i < _stages.size(); i++){
+                if (_stages[i]->work(_in, _out) != int(n)){
+                    throw std::runtime_error("inplace_chain: " + _stages[i]->name() + " did not produce every item");
+                }
+                _in[0]._mem = _out[0]._mem; //the next stage works in place
+            }
+        }
+        return noutput_items;
+    }
+
+private:
+    const std::vector<block_sptr> _stages;
+    const size_t _itemsize;
+    size_t _tile;
+    InputItems _in;
+    OutputItems _out;
+};
+
+/***********************************************************************
+ * factory function
+ **********************************************************************/
+inplace_chain::sptr inplace_chain::make(const std::vector<gr_basic_block_sptr> &basic_blocks){
+    if (basic_blocks.empty()){
+        throw std::invalid_argument("inplace_chain: needs at least one stage");
+    }
+    std::vector<block_sptr> stages;
+    BOOST_FOREACH(const gr_basic_block_sptr &basic_block, basic_blocks){
+        stages.push_back(to_stage(basic_block));
+    }
+    const size_t itemsize = stages.front()->input_signature()->sizeof_stream_item(0);
+    BOOST_FOREACH(const block_sptr &stage, stages){
+        if (size_t(stage->input_signature()->sizeof_stream_item(0)) != itemsize){
+            throw std::invalid_argument("inplace_chain: " + stage->name() + " has a different item size");
+        }
+    }
+    return gnuradio::get_initial_sptr(new inplace_chain_impl(stages, itemsize));
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gnuradio/msg_block.h>
+#include <gr_block.h>
+#include <gr_block_detail.h>
+#include <gr_buffer.h>
+#include <gr_io_signature.h>
+#include <gr_tpb_detail.h>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/tss.hpp>
+#include <deque>
+#include <stdexcept>
+#include "msg_queue.h"
+#include "block_trace.h"
+#include "thread_sched.h"
+
+using namespace gnuradio;
+
+class msg_block_master;
+
+static void no_cleanup(msg_block_master *)
+{
+    //NOP
+}
+
+//! the master whose handle_msg() is running on the calling thread
+static boost::thread_specific_ptr<msg_block_master> servicing(&no_cleanup);
+
+//! the marker a block's sourcer puts before a control message (see block.cc)
+static const pmt::pmt_t &msg_priority_key(void)
+{
+    static const pmt::pmt_t key = pmt::pmt_string_to_symbol("extras_msg_control");
+    return key;
+}
+
+static gr_tag_t make_control_marker(void)
+{
+    gr_tag_t tag;
+    tag.offset = 0;
+    tag.key = msg_priority_key();
+    tag.value = pmt::PMT_T;
+    tag.srcid = pmt::PMT_F;
+    return tag;
+}
+
+//! posts from other threads flag a control message in the top bit of the offset
+static const uint64_t pending_control_bit = uint64_t(1) << 63;
+
+/***********************************************************************
+ * The msg master block
+ *
+ * One gr_block with a 1-byte stream per message port.
+ * Input messages are read as tags and handed to the parent,
+ * output messages are written as one tag per item.
+ * Control messages keep the marker tag at their offset,
+ * so their priority survives a msg block on the way.
+ * Posts from other threads go through a queue that wakes the
+ * scheduler thread with the same condition that upstream signals.
+ **********************************************************************/
+class msg_block_master : public gr_block
+{
+public:
+    msg_block_master(
+        const std::string &name,
+        const size_t num_inputs,
+        const size_t num_outputs,
+        msg_block *parent
+    ):
+        gr_block(
+            name,
+            gr_make_io_signature(num_inputs, num_inputs, 1),
+            gr_make_io_signature(num_outputs, num_outputs, 1)
+        ),
+        _parent(parent),
+        _noutput_items(0),
+        _produced(num_outputs, 0),
+        _backlog(num_outputs),
+        _nbacklog(0),
+        _priority(block::MSG_PRIORITY_BULK)
+    {
+        _pending.set_notify_hook(boost::bind(&msg_block_master::notify_input, this));
+    }
+
+    bool start(void)
+    {
+        sched.apply();
+        _pending.open();
+        return _parent->start();
+    }
+
+    bool stop(void)
+    {
+        _pending.close(); //unblocks posters waiting on a full queue
+        return _parent->stop();
+    }
+
+    //! any amount of input will do, work waits when there is nothing
+    void forecast(int, gr_vector_int &ninput_items_required)
+    {
+        for (size_t i = 0; i < ninput_items_required.size(); i++)
+        {
+            ninput_items_required[i] = 0;
+        }
+    }
+
+    int general_work(
+        int noutput_items,
+        gr_vector_int &ninput_items,
+        gr_vector_const_void_star &,
+        gr_vector_void_star &
+    ){
+        _noutput_items = size_t(noutput_items);
+        std::fill(_produced.begin(), _produced.end(), 0);
+
+        while (true)
+        {
+            if (this->service(ninput_items)) break;
+            if (this->inputs_done()) return WORK_DONE;
+
+            //sleep until upstream produces or a post arrives
+            this->wait_for_change();
+
+            //a block with inputs returns to let the scheduler recount them,
+            //a source may not return empty handed, so it loops to the queue
+            if (!ninput_items.empty()) break;
+        }
+
+        for (size_t i = 0; i < _produced.size(); i++)
+        {
+            this->produce(i, int(_produced[i]));
+        }
+        return WORK_CALLED_PRODUCE;
+    }
+
+    thread_sched sched;
+
+    void post_msg(const size_t which_output, const gr_tag_t &msg, const block::msg_priority priority)
+    {
+        if (which_output >= _produced.size())
+        {
+            throw std::invalid_argument("msg_block::post_msg: output port index out of range");
+        }
+        const bool control = (priority == block::MSG_PRIORITY_CONTROL);
+
+        //from handle_msg(), straight to the output stream
+        if (servicing.get() == this)
+        {
+            this->emit(which_output, msg, control);
+            return;
+        }
+
+        //from another thread, the port index rides in the offset
+        gr_tag_t pending = msg;
+        pending.offset = which_output;
+        if (control) pending.offset |= pending_control_bit;
+        _pending.push(pending);
+    }
+
+    //! the priority of the message in handle_msg()
+    block::msg_priority priority(void) const
+    {
+        return _priority;
+    }
+
+private:
+    //! flush posts and handle input messages, true when any work was done
+    bool service(gr_vector_int &ninput_items)
+    {
+        trace::scope trace_scope(trace::EVENT_WORK, this->unique_id());
+        servicing.reset(this);
+        this->flush();
+
+        bool consumed = false;
+        for (size_t i = 0; i < ninput_items.size(); i++)
+        {
+            if (ninput_items[i] == 0) continue;
+            const uint64_t nread = this->nitems_read(i);
+            this->get_tags_in_range(_tags, i, nread, nread + ninput_items[i]);
+            this->consume(i, ninput_items[i]);
+            consumed = true;
+            //a marker tag makes the next message control priority
+            for (size_t j = 0; j < _tags.size(); j++)
+            {
+                if (pmt::pmt_eq(_tags[j].key, msg_priority_key()))
+                {
+                    _priority = block::MSG_PRIORITY_CONTROL;
+                    continue;
+                }
+                _parent->handle_msg(i, _tags[j]);
+                _priority = block::MSG_PRIORITY_BULK;
+            }
+        }
+        _tags.clear(); //resets PMT refs
+        servicing.reset();
+
+        for (size_t i = 0; i < _produced.size(); i++)
+        {
+            if (_produced[i] != 0) return true;
+        }
+        return consumed;
+    }
+
+    //! send the backlog, then the posts from other threads
+    void flush(void)
+    {
+        for (size_t i = 0; i < _backlog.size(); i++)
+        {
+            while (!_backlog[i].empty() && _produced[i] < _noutput_items)
+            {
+                this->write_tag(i, _backlog[i].front());
+                _backlog[i].pop_front();
+                _nbacklog--;
+            }
+        }
+
+        //stop taking posts once a port backs up, so posters feel the pressure
+        gr_tag_t msg;
+        while (_nbacklog == 0 && _pending.try_pop(msg))
+        {
+            const size_t which_output = size_t(msg.offset & ~pending_control_bit);
+            this->emit(which_output, msg, (msg.offset & pending_control_bit) != 0);
+        }
+    }
+
+    //! write a message to a port, or hold it when the port is full
+    void emit(const size_t which_output, const gr_tag_t &msg, const bool control)
+    {
+        if (control) this->emit(which_output, make_control_marker(), false);
+        if (_backlog[which_output].empty() && _produced[which_output] < _noutput_items)
+        {
+            this->write_tag(which_output, msg);
+        }
+        else
+        {
+            _backlog[which_output].push_back(msg);
+            _nbacklog++;
+        }
+    }
+
+    void write_tag(const size_t which_output, const gr_tag_t &msg)
+    {
+        gr_tag_t tag = msg;
+        tag.offset = this->nitems_written(which_output) + _produced[which_output];
+        this->add_item_tag(which_output, tag);
+
+        //the marker shares the item of the message after it
+        if (!pmt::pmt_eq(tag.key, msg_priority_key())) _produced[which_output]++;
+    }
+
+    //! true when every input has ended and there is nothing left to read
+    bool inputs_done(void)
+    {
+        gr_block_detail_sptr d = this->detail();
+        if (!d || d->ninputs() == 0) return false;
+        for (size_t i = 0; i < size_t(d->ninputs()); i++)
+        {
+            if (!d->input(i)->done()) return false;
+            if (d->input(i)->items_available() != 0) return false;
+        }
+        return true;
+    }
+
+    void notify_input(void)
+    {
+        gr_block_detail_sptr d = this->detail();
+        if (d) d->d_tpb.set_input_changed();
+    }
+
+    void wait_for_change(void)
+    {
+        gr_tpb_detail &tpb = this->detail()->d_tpb;
+        gruel::scoped_lock lock(tpb.mutex);
+
+        //a source has no upstream, so any set flag came from the queue
+        //and was already serviced: clear it to avoid spinning on it
+        if (this->detail()->ninputs() == 0) tpb.input_changed = false;
+
+        while (!tpb.input_changed && _pending.empty())
+        {
+            tpb.input_cond.wait(lock); //interruption point for stop
+        }
+    }
+
+    msg_block *_parent;
+    size_t _noutput_items;
+    std::vector<size_t> _produced;
+    std::vector<std::deque<gr_tag_t> > _backlog;
+    size_t _nbacklog;
+    block::msg_priority _priority;
+    std::vector<gr_tag_t> _tags;
+    msg_queue<gr_tag_t> _pending;
+};
+
+/***********************************************************************
+ * The msg block object itself
+ **********************************************************************/
+
+//! The private guts of a msg block object
+struct msg_block::impl
+{
+    boost::shared_ptr<msg_block_master> master;
+};
+
+msg_block::msg_block(
+    const std::string &name,
+    const size_t num_inputs,
+    const size_t num_outputs
+):
+    gr_hier_block2(
+        name + " wrapper",
+        gr_make_io_signature(num_inputs, num_inputs, 1),
+        gr_make_io_signature(num_outputs, num_outputs, 1)
+    )
+{
+    if (num_inputs == 0 && num_outputs == 0)
+    {
+        throw std::invalid_argument("msg_block: " + name + " needs at least one message port");
+    }
+
+    _impl = boost::make_shared<impl>();
+    _impl->master = boost::make_shared<msg_block_master>(name, num_inputs, num_outputs, this);
+    trace::register_name(_impl->master->unique_id(), name);
+
+    //connect internal sink ports
+    for (size_t i = 0; i < num_inputs; i++)
+    {
+        this->connect(this->self(), i, _impl->master, i);
+    }
+
+    //connect internal source ports
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        this->connect(_impl->master, i, this->self(), i);
+    }
+}
+
+msg_block::~msg_block(void)
+{
+    _impl.reset();
+}
+
+void msg_block::handle_msg(const size_t, const gr_tag_t &)
+{
+    //NOP
+}
+
+block::msg_priority msg_block::current_msg_priority(void) const
+{
+    return _impl->master->priority();
+}
+
+void msg_block::post_msg(const size_t which_output, const gr_tag_t &msg, const block::msg_priority priority)
+{
+    trace::scope trace_scope(trace::EVENT_POST_MSG, this->unique_id());
+    _impl->master->post_msg(which_output, msg, priority);
+}
+
+void msg_block::post_msg(
+    const size_t which_output,
+    const pmt::pmt_t &key,
+    const pmt::pmt_t &value,
+    const pmt::pmt_t &srcid,
+    const block::msg_priority priority
+){
+    gr_tag_t tag;
+    tag.offset = 0; //not used
+    tag.key = key;
+    tag.value = value;
+    tag.srcid = srcid;
+    this->post_msg(which_output, tag, priority);
+}
+
+long msg_block::unique_id(void) const
+{
+    return _impl->master->unique_id();
+}
+
+std::string msg_block::name(void) const
+{
+    return _impl->master->name();
+}
+
+void msg_block::set_processor_affinity(const std::vector<int> &cpus)
+{
+    _impl->master->sched.affinity = cpus;
+}
+
+void msg_block::set_thread_priority(const double priority, const bool realtime)
+{
+    _impl->master->sched.priority = priority;
+    _impl->master->sched.realtime = realtime;
+    _impl->master->sched.has_priority = true;
+}
+
+bool msg_block::start(void)
+{
+    return true;
+}
+
+bool msg_block::stop(void)
+{
+    return true;
+}
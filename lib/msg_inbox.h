@@ -0,0 +1,371 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_MSG_INBOX_H
+#define INCLUDED_GR_EXTRAS_MSG_INBOX_H
+
+#include "msg_queue.h"
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+
+namespace gnuradio{
+
+/*!
+ * One message input port: a bounded queue plus an overflow policy.
+ * Producers push into the port, the inbox pops from all of its ports.
+ * Control messages have their own lane, which always blocks on overflow,
+ * and the inbox drains the control lanes before the bulk lanes.
+ */
+template <typename T>
+class msg_port
+{
+public:
+    enum overflow_policy
+    {
+        OVERFLOW_BLOCK, //producer sleeps until there is room
+        OVERFLOW_DROP_NEWEST, //the new message is dropped
+        OVERFLOW_DROP_OLDEST, //the oldest message in the port is dropped
+    };
+
+    enum priority
+    {
+        PRIORITY_BULK, //data, subject to the overflow policy
+        PRIORITY_CONTROL, //settings and commands, popped first
+    };
+
+    msg_port(const size_t capacity = 1024):
+        _policy(OVERFLOW_BLOCK), _dropped(0), _queue(new msg_queue<T>(capacity)),
+        _control(new msg_queue<T>(capacity))
+    {
+        //NOP
+    }
+
+    //! Replace the queue, only call this while nothing is pushing or popping
+    void configure(const size_t capacity, const overflow_policy policy)
+    {
+        _queue.reset(new msg_queue<T>(capacity));
+        _queue->set_notify_hook(_hook);
+        _policy = policy;
+    }
+
+    void set_notify_hook(const boost::function<void(void)> &hook)
+    {
+        _hook = hook;
+        _queue->set_notify_hook(_hook);
+        _control->set_notify_hook(_hook);
+    }
+
+    /*!
+     * Push a message according to the overflow policy.
+     * \return false if the message was dropped
+     */
+    bool push(const T &msg, const boost::atomic<bool> *abort = NULL)
+    {
+        switch (_policy)
+        {
+        case OVERFLOW_DROP_NEWEST:
+            if (_queue->try_push(msg)) return true;
+            _dropped.fetch_add(1, boost::memory_order_relaxed);
+            return false;
+
+        case OVERFLOW_DROP_OLDEST:
+            while (!_queue->try_push(msg))
+            {
+                T oldest;
+                if (_queue->try_pop(oldest)) _dropped.fetch_add(1, boost::memory_order_relaxed);
+            }
+            return true;
+
+        default: return _queue->push(msg, abort);
+        }
+    }
+
+    //! Push a message into the lane for its priority
+    bool push(const T &msg, const priority prio, const boost::atomic<bool> *abort = NULL)
+    {
+        if (prio == PRIORITY_CONTROL) return _control->push(msg, abort);
+        return this->push(msg, abort);
+    }
+
+    //! Push a range of messages according to the overflow policy
+    template <typename Iter>
+    bool push_batch(Iter first, Iter last, const boost::atomic<bool> *abort = NULL)
+    {
+        if (_policy == OVERFLOW_BLOCK) return _queue->push_batch(first, last, abort);
+        bool ok = true;
+        for (; first != last; ++first) ok = this->push(*first, abort) && ok;
+        return ok;
+    }
+
+    void wake_pushers(void)
+    {
+        _queue->wake_pushers();
+        _control->wake_pushers();
+    }
+
+    msg_queue<T> &queue(void)
+    {
+        return *_queue;
+    }
+
+    msg_queue<T> &control_queue(void)
+    {
+        return *_control;
+    }
+
+    //! The number of messages dropped by the overflow policy
+    size_t dropped(void) const
+    {
+        return _dropped.load(boost::memory_order_relaxed);
+    }
+
+private:
+    overflow_policy _policy;
+    boost::atomic<size_t> _dropped;
+    boost::scoped_ptr<msg_queue<T> > _queue;
+    boost::scoped_ptr<msg_queue<T> > _control;
+    boost::function<void(void)> _hook;
+};
+
+/*!
+ * The message inbox of a block: one bounded port per message input.
+ *
+ * The consumer pops from the ports round-robin, control lanes first,
+ * so messages keep their order within a port and priority,
+ * but not across ports or priorities.
+ * Every port notifies the inbox on push, so the consumer sleeps
+ * on a single condition variable no matter the number of ports.
+ */
+template <typename T>
+class msg_inbox
+{
+public:
+    msg_inbox(void):
+        _waiters(0), _hook_waiters(0), _next(0)
+    {
+        //NOP
+    }
+
+    //! Create the ports, call this before anything else
+    void resize(const size_t num_ports)
+    {
+        _ports.clear();
+        for (size_t i = 0; i < num_ports; i++)
+        {
+            _ports.push_back(boost::shared_ptr<msg_port<T> >(new msg_port<T>()));
+            _ports.back()->set_notify_hook(boost::bind(&msg_inbox::notify, this));
+        }
+    }
+
+    msg_port<T> &port(const size_t index)
+    {
+        return *_ports.at(index);
+    }
+
+    //! True when no port has a message ready to pop
+    bool empty(void) const
+    {
+        for (size_t i = 0; i < _ports.size(); i++)
+        {
+            if (!_ports[i]->queue().empty()) return false;
+            if (!_ports[i]->control_queue().empty()) return false;
+        }
+        return true;
+    }
+
+    //! The number of messages in all ports (a snapshot)
+    size_t size(void) const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < _ports.size(); i++)
+        {
+            n += _ports[i]->queue().size();
+            n += _ports[i]->control_queue().size();
+        }
+        return n;
+    }
+
+    /*!
+     * The deepest any port queue got after a push.
+     * Each queue tracks its own mark when pushed,
+     * this walks the ports, so only call it for stats.
+     */
+    size_t high_water(void) const
+    {
+        size_t high = 0;
+        for (size_t i = 0; i < _ports.size(); i++)
+        {
+            high = std::max(high, _ports[i]->queue().high_water());
+            high = std::max(high, _ports[i]->control_queue().high_water());
+        }
+        return high;
+    }
+
+    //! Pop a message from the next port that has one, false if all are empty
+    bool try_pop(T &msg)
+    {
+        const size_t n = _ports.size();
+        const size_t next = _next;
+        for (size_t i = 0; i < n; i++)
+        {
+            const size_t index = (next + i) % n;
+            if (_ports[index]->control_queue().try_pop(msg))
+            {
+                _next = (index + 1) % n;
+                return true;
+            }
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            const size_t index = (next + i) % n;
+            if (_ports[index]->queue().try_pop(msg))
+            {
+                _next = (index + 1) % n;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Pop a message, sleeping while the inbox is empty
+    bool pop(T &msg)
+    {
+        return this->pop(msg, -1.0);
+    }
+
+    /*!
+     * Pop a message, sleeping up to timeout seconds while the inbox is empty.
+     * A negative timeout sleeps forever, a zero timeout does not sleep.
+     * \return false on timeout
+     */
+    bool pop(T &msg, const double timeout)
+    {
+        const boost::system_time deadline = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        while (!this->try_pop(msg))
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            _waiters.fetch_add(1, boost::memory_order_seq_cst);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            bool timed_out = false;
+            if (this->empty())
+            {
+                if (timeout < 0) _cond.wait(lock);
+                else timed_out = !_cond.timed_wait(lock, deadline);
+            }
+            _waiters.fetch_sub(1, boost::memory_order_relaxed);
+            lock.unlock();
+            if (timed_out) return this->try_pop(msg);
+        }
+        return true;
+    }
+
+    /*!
+     * Pop up to max messages, appending them to msgs.
+     * Sleeps up to timeout seconds for the first message (see pop()),
+     * then takes whatever else is ready without sleeping.
+     * \return the number of messages popped
+     */
+    size_t pop_batch(std::vector<T> &msgs, const size_t max, const double timeout)
+    {
+        T msg;
+        if (max == 0 || !this->pop(msg, timeout)) return 0;
+        msgs.push_back(msg);
+
+        size_t n = 1;
+        for (; n < max && this->try_pop(msg); n++)
+        {
+            msgs.push_back(msg);
+        }
+        return n;
+    }
+
+    /*!
+     * Sleep up to timeout seconds until a message is ready, without popping it.
+     * \return true when a message is ready to pop
+     */
+    bool wait(const double timeout)
+    {
+        const boost::system_time deadline = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        boost::mutex::scoped_lock lock(_mutex);
+        _waiters.fetch_add(1, boost::memory_order_seq_cst);
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        while (this->empty())
+        {
+            if (timeout < 0) _cond.wait(lock);
+            else if (!_cond.timed_wait(lock, deadline)) break;
+        }
+        _waiters.fetch_sub(1, boost::memory_order_relaxed);
+        return !this->empty();
+    }
+
+    /*!
+     * Set a hook to wake a thread that sleeps on something other than the inbox.
+     * The hook is called after a push, but only between begin/end_hook_wait().
+     * Set the hook before any thread may push.
+     */
+    void set_notify_hook(const boost::function<void(void)> &hook)
+    {
+        _hook = hook;
+    }
+
+    //! Make pushes call the notify hook, call before checking empty()
+    void begin_hook_wait(void)
+    {
+        _hook_waiters.fetch_add(1, boost::memory_order_seq_cst);
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+    }
+
+    //! Undo begin_hook_wait()
+    void end_hook_wait(void)
+    {
+        _hook_waiters.fetch_sub(1, boost::memory_order_relaxed);
+    }
+
+private:
+    //! called by the ports after every push
+    void notify(void)
+    {
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        if (_waiters.load(boost::memory_order_relaxed) != 0)
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            lock.unlock();
+            _cond.notify_all();
+        }
+        if (_hook_waiters.load(boost::memory_order_relaxed) != 0 && _hook) _hook();
+    }
+
+    std::vector<boost::shared_ptr<msg_port<T> > > _ports;
+    boost::atomic<size_t> _waiters;
+    boost::atomic<size_t> _hook_waiters;
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    boost::function<void(void)> _hook;
+    size_t _next;
+};
+
+} //namespace gnuradio
+
+#endif /* INCLUDED_GR_EXTRAS_MSG_INBOX_H */
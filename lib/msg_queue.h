@@ -0,0 +1,402 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_MSG_QUEUE_H
+#define INCLUDED_GR_EXTRAS_MSG_QUEUE_H
+
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace gnuradio{
+
+/*!
+ * A bounded lock-free message queue.
+ *
+ * Any number of threads may push and pop concurrently.
+ * Push and pop are a handful of atomic operations on a ring of cells;
+ * the mutex and condition variables are only touched when a consumer
+ * has found the queue empty (or a producer found it full) and must sleep.
+ *
+ * When the ring is full, push() sleeps until a consumer makes room.
+ * A closed queue wakes any sleeping consumers, and pop() will then
+ * return false once the queue is empty.
+ */
+template <typename T>
+class msg_queue
+{
+public:
+    msg_queue(const size_t capacity = 1024):
+        _high_water(0), _pop_waiters(0), _push_waiters(0), _closed(false)
+    {
+        //round the ring up to a power of two for cheap index masking,
+        //the exact capacity is enforced when claiming a cell
+        _capacity = (capacity == 0)? 1 : capacity;
+        size_t size = 2;
+        while (size < _capacity) size <<= 1;
+        _mask = size - 1;
+
+        _cells.reset(new cell[size]);
+        for (size_t i = 0; i < size; i++)
+        {
+            _cells[i].seq.store(i, boost::memory_order_relaxed);
+        }
+        _head.store(0, boost::memory_order_relaxed);
+        _tail.store(0, boost::memory_order_relaxed);
+    }
+
+    //! Push a message, return false if the ring is full
+    bool try_push(const T &msg)
+    {
+        if (!this->enqueue(msg)) return false;
+        this->notify_pop();
+        return true;
+    }
+
+    /*!
+     * Push a message, sleeping while the ring is full.
+     * \return false if the queue was closed while full (message dropped)
+     */
+    bool push(const T &msg)
+    {
+        return this->push(msg, NULL);
+    }
+
+    /*!
+     * Push a message, sleeping while the ring is full,
+     * but give up once the abort flag has been set.
+     * Set the flag and call wake_pushers() to release a sleeping push.
+     * \return false if closed or aborted while full (message dropped)
+     */
+    bool push(const T &msg, const boost::atomic<bool> *abort)
+    {
+        while (!this->try_push(msg))
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            if (_closed) return false;
+            _push_waiters.fetch_add(1, boost::memory_order_seq_cst);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            const bool aborted = abort != NULL && abort->load(boost::memory_order_relaxed);
+            if (!aborted && this->full()) _push_cond.wait(lock);
+            _push_waiters.fetch_sub(1, boost::memory_order_relaxed);
+            if (aborted) return false;
+        }
+        return true;
+    }
+
+    //! Wake any producers sleeping in push()
+    void wake_pushers(void)
+    {
+        this->notify(_push_waiters, _push_cond);
+    }
+
+    /*!
+     * Push a range of messages, sleeping while the ring is full.
+     * Consumers are notified once for the whole batch.
+     * \return false if closed or aborted while full (rest dropped)
+     */
+    template <typename Iter>
+    bool push_batch(Iter first, Iter last, const boost::atomic<bool> *abort = NULL)
+    {
+        for (; first != last; ++first)
+        {
+            if (this->enqueue(*first)) continue;
+            //full: let consumers see what is in there, then sleep
+            this->notify_pop();
+            if (!this->push(*first, abort)) return false;
+        }
+        this->notify_pop();
+        return true;
+    }
+
+    //! Pop a message, return false if the ring is empty
+    bool try_pop(T &msg)
+    {
+        size_t pos = 0;
+        if (!this->dequeue(msg, pos)) return false;
+
+        //only wake sleeping producers once half of the ring is free,
+        //so a full queue does not ping-pong threads on every message
+        if (_tail.load(boost::memory_order_relaxed) - (pos + 1) <= _capacity/2)
+        {
+            this->notify(_push_waiters, _push_cond);
+        }
+        return true;
+    }
+
+    /*!
+     * Pop a message, sleeping while the queue is empty.
+     * \return false if the queue is empty and has been closed
+     */
+    bool pop(T &msg)
+    {
+        while (!this->try_pop(msg))
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            if (_closed) return false;
+            _pop_waiters.fetch_add(1, boost::memory_order_seq_cst);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (this->empty()) _pop_cond.wait(lock);
+            _pop_waiters.fetch_sub(1, boost::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /*!
+     * Pop a message, sleeping up to timeout seconds while the queue is empty.
+     * A negative timeout sleeps forever, a zero timeout does not sleep.
+     * \return false on timeout, or if the queue is empty and has been closed
+     */
+    bool pop(T &msg, const double timeout)
+    {
+        if (timeout < 0) return this->pop(msg);
+        const boost::system_time deadline = to_deadline(timeout);
+        while (!this->try_pop(msg))
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            if (_closed) return false;
+            _pop_waiters.fetch_add(1, boost::memory_order_seq_cst);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            bool timed_out = false;
+            if (this->empty()) timed_out = !_pop_cond.timed_wait(lock, deadline);
+            _pop_waiters.fetch_sub(1, boost::memory_order_relaxed);
+            lock.unlock();
+            if (timed_out) return this->try_pop(msg);
+        }
+        return true;
+    }
+
+    /*!
+     * Pop up to max messages, appending them to msgs.
+     * Sleeps up to timeout seconds for the first message (see pop()),
+     * then takes whatever else is ready without sleeping.
+     * Producers are notified once for the whole batch.
+     * \return the number of messages popped
+     */
+    size_t pop_batch(std::vector<T> &msgs, const size_t max, const double timeout)
+    {
+        T msg;
+        if (max == 0 || !this->pop(msg, timeout)) return 0;
+        msgs.push_back(msg);
+
+        size_t n = 1, pos = 0;
+        for (; n < max && this->dequeue(msg, pos); n++)
+        {
+            msgs.push_back(msg);
+        }
+        if (n > 1) this->notify(_push_waiters, _push_cond);
+        return n;
+    }
+
+    /*!
+     * Sleep up to timeout seconds until a message is ready, without popping it.
+     * A negative timeout sleeps forever, a zero timeout does not sleep.
+     * \return true when a message is ready to pop
+     */
+    bool wait(const double timeout)
+    {
+        const boost::system_time deadline = to_deadline(timeout);
+        boost::mutex::scoped_lock lock(_mutex);
+        _pop_waiters.fetch_add(1, boost::memory_order_seq_cst);
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        while (this->empty() && !_closed)
+        {
+            if (timeout < 0) _pop_cond.wait(lock);
+            else if (!_pop_cond.timed_wait(lock, deadline)) break;
+        }
+        _pop_waiters.fetch_sub(1, boost::memory_order_relaxed);
+        return !this->empty();
+    }
+
+    /*!
+     * Set a hook that is called after every push,
+     * ex: to wake a thread that sleeps on more than this queue.
+     * Set the hook before any thread may push.
+     */
+    void set_notify_hook(const boost::function<void(void)> &hook)
+    {
+        _hook = hook;
+    }
+
+    //! True when there is no message ready to pop
+    bool empty(void) const
+    {
+        const size_t pos = _head.load(boost::memory_order_relaxed);
+        return _cells[pos & _mask].seq.load(boost::memory_order_acquire) != pos + 1;
+    }
+
+    //! True when there is no free cell to push into
+    bool full(void) const
+    {
+        const size_t pos = _tail.load(boost::memory_order_relaxed);
+        if (ptrdiff_t(pos - _head.load(boost::memory_order_relaxed)) >= ptrdiff_t(_capacity)) return true;
+        return _cells[pos & _mask].seq.load(boost::memory_order_acquire) != pos;
+    }
+
+    //! The number of messages in the queue (a snapshot)
+    size_t size(void) const
+    {
+        const size_t head = _head.load(boost::memory_order_relaxed);
+        const ptrdiff_t n = ptrdiff_t(_tail.load(boost::memory_order_relaxed) - head);
+        return (n < 0)? 0 : size_t(n);
+    }
+
+    //! The largest number of messages seen in the queue after a push
+    size_t high_water(void) const
+    {
+        return _high_water.load(boost::memory_order_relaxed);
+    }
+
+    //! The number of messages this queue holds before it is full
+    size_t capacity(void) const
+    {
+        return _capacity;
+    }
+
+    //! Allow pop() to sleep again on an empty queue
+    void open(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _closed = false;
+    }
+
+    //! Wake up sleepers, make pop() return on empty and push() drop on full
+    void close(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _closed = true;
+        lock.unlock();
+        _pop_cond.notify_all();
+        _push_cond.notify_all();
+    }
+
+private:
+    //! claim a cell and fill it, false when full
+    bool enqueue(const T &msg)
+    {
+        size_t pos = _tail.load(boost::memory_order_relaxed);
+        size_t head = 0;
+        cell *c = NULL;
+        while (true)
+        {
+            //concurrent producers may overshoot the capacity by one each
+            head = _head.load(boost::memory_order_relaxed);
+            if (ptrdiff_t(pos - head) >= ptrdiff_t(_capacity)) return false; //full
+            c = &_cells[pos & _mask];
+            const size_t seq = c->seq.load(boost::memory_order_acquire);
+            const ptrdiff_t dif = ptrdiff_t(seq) - ptrdiff_t(pos);
+            if (dif == 0)
+            {
+                if (_tail.compare_exchange_weak(pos, pos + 1, boost::memory_order_relaxed)) break;
+            }
+            else if (dif < 0) return false; //full
+            else pos = _tail.load(boost::memory_order_relaxed);
+        }
+
+        c->data = msg;
+        c->seq.store(pos + 1, boost::memory_order_release);
+
+        //the depth after this push, from the head seen when claiming the cell
+        const size_t depth = pos + 1 - head;
+        size_t high = _high_water.load(boost::memory_order_relaxed);
+        while (depth > high && !_high_water.compare_exchange_weak(high, depth, boost::memory_order_relaxed)){}
+        return true;
+    }
+
+    //! claim a cell and empty it, false when empty
+    bool dequeue(T &msg, size_t &pos)
+    {
+        pos = _head.load(boost::memory_order_relaxed);
+        cell *c = NULL;
+        while (true)
+        {
+            c = &_cells[pos & _mask];
+            const size_t seq = c->seq.load(boost::memory_order_acquire);
+            const ptrdiff_t dif = ptrdiff_t(seq) - ptrdiff_t(pos + 1);
+            if (dif == 0)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, boost::memory_order_relaxed)) break;
+            }
+            else if (dif < 0) return false; //empty
+            else pos = _head.load(boost::memory_order_relaxed);
+        }
+
+        msg = c->data;
+        c->data = T(); //resets ref counts
+        c->seq.store(pos + _mask + 1, boost::memory_order_release);
+        return true;
+    }
+
+    static boost::system_time to_deadline(const double timeout)
+    {
+        return boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1e6));
+    }
+
+    //! wake consumers, and whoever listens through the hook
+    void notify_pop(void)
+    {
+        this->notify(_pop_waiters, _pop_cond);
+        if (_hook) _hook();
+    }
+
+    //! wake sleepers, but only pay for the lock when one is sleeping
+    void notify(boost::atomic<size_t> &waiters, boost::condition_variable &cond)
+    {
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        if (waiters.load(boost::memory_order_relaxed) == 0) return;
+        boost::mutex::scoped_lock lock(_mutex);
+        lock.unlock();
+        cond.notify_all();
+    }
+
+    struct cell
+    {
+        boost::atomic<size_t> seq;
+        T data;
+    };
+
+    boost::scoped_array<cell> _cells;
+    size_t _capacity;
+    size_t _mask;
+    char _pad0[64];
+    boost::atomic<size_t> _head;
+    char _pad1[64];
+    boost::atomic<size_t> _tail;
+    char _pad2[64];
+    boost::atomic<size_t> _high_water;
+    boost::atomic<size_t> _pop_waiters;
+    boost::atomic<size_t> _push_waiters;
+    boost::function<void(void)> _hook;
+    boost::mutex _mutex;
+    boost::condition_variable _pop_cond;
+    boost::condition_variable _push_cond;
+    bool _closed;
+};
+
+} //namespace gnuradio
+
+#endif /* INCLUDED_GR_EXTRAS_MSG_QUEUE_H */
@@ -23,12 +23,44 @@
 #include <gr_io_signature.h>
 #include <stdexcept>
 #include <complex>
-#include <volk/volk.h>
+#include <boost/atomic.hpp>
+#include "op_kernels.h"
+#include "work_pool.h"
 
 using namespace gnuradio::extras;
 
 /***********************************************************************
- * Templated multipler class
+ * Kernel selection, only the 8 and 16 bit integers have a Q7/Q15 mode
+ **********************************************************************/
+template <typename type>
+static void multiply_items(type *out, const type *const *in, const size_t m, const size_t n, const bool){
+    gnuradio::kernels::multiply(out, in, m, n);
+}
+
+template <typename type>
+static void multiply_sat_items(type *out, const type *const *in, const size_t m, const size_t n, const bool saturate){
+    if (saturate) gnuradio::kernels::multiply_sat(out, in, m, n);
+    else gnuradio::kernels::multiply(out, in, m, n);
+}
+
+static void multiply_items(int8_t *out, const int8_t *const *in, const size_t m, const size_t n, const bool saturate){
+    multiply_sat_items(out, in, m, n, saturate);
+}
+
+static void multiply_items(int16_t *out, const int16_t *const *in, const size_t m, const size_t n, const bool saturate){
+    multiply_sat_items(out, in, m, n, saturate);
+}
+
+static void multiply_items(std::complex<int8_t> *out, const std::complex<int8_t> *const *in, const size_t m, const size_t n, const bool saturate){
+    multiply_sat_items(out, in, m, n, saturate);
+}
+
+static void multiply_items(std::complex<int16_t> *out, const std::complex<int16_t> *const *in, const size_t m, const size_t n, const bool saturate){
+    multiply_sat_items(out, in, m, n, saturate);
+}
+
+/***********************************************************************
+ * Templated multipler class - calls the SIMD kernels
  **********************************************************************/
 template <typename type>
 class multiply_generic : public multiply{
@@ -39,103 +71,42 @@ public:
             gr_make_io_signature (num_inputs, num_inputs, sizeof(type)*vlen),
             gr_make_io_signature (1, 1, sizeof(type)*vlen)
         ),
-        _vlen(vlen)
+        _vlen(vlen),
+        _ins(num_inputs),
+        _saturate(false)
     {
-        const int alignment_multiple = get_work_multiple() / (sizeof(type)*vlen);
-        set_output_multiple(std::max(1, alignment_multiple));
+        //NOP
     }
 
-    size_t get_work_multiple(void);
+    void set_saturate(const bool saturate){
+        _saturate.store(saturate, boost::memory_order_relaxed);
+    }
 
     int work(
         const InputItems &input_items,
         const OutputItems &output_items
-    );
-
-private:
-    const size_t _vlen;
-};
-
-/***********************************************************************
- * Generic multiplier implementation
- **********************************************************************/
-template <typename type>
-size_t multiply_generic<type>::get_work_multiple(void)
-{
-    return 1;
-}
-
-template <typename type>
-int multiply_generic<type>::work(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t n_nums = output_items[0].size() * _vlen;
-    type *out = output_items[0].cast<type *>();
-    const type *in0 = input_items[0].cast<const type *>();
-
-    for (size_t n = 1; n < input_items.size(); n++){
-        const type *in = input_items[n].cast<const type *>();
-        for (size_t i = 0; i < n_nums; i++){
-            out[i] = in0[i] * in[i];
+    ){
+        for (size_t n = 0; n < input_items.size(); n++){
+            _ins[n] = input_items[n].cast<const type *>();
         }
-        in0 = out; //for next input, we do output += input
-    }
-
-    return output_items[0].size();
-}
-
-/***********************************************************************
- * Multiplier implementation with complex complex float32 - calls volk
- **********************************************************************/
-template <>
-size_t multiply_generic<std::complex<float> >::get_work_multiple(void)
-{
-    return volk_get_alignment();
-}
 
-template <>
-int multiply_generic<std::complex<float> >::work(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t n_nums = output_items[0].size() * _vlen;
-    std::complex<float> *out = output_items[0].cast<std::complex<float> *>();
-    const std::complex<float> *in0 = input_items[0].cast<const std::complex<float> *>();
-
-    for (size_t n = 1; n < input_items.size(); n++){
-        const std::complex<float> *in = input_items[n].cast<const std::complex<float> *>();
-        volk_32fc_x2_multiply_32fc_a(out, in0, in, n_nums);
-        in0 = out; //for next input, we do output += input
+        //one pass over all inputs, output = input0 * input1 * ...
+        const size_t noutput_items = output_items[0].size();
+        const size_t n_nums = noutput_items * _vlen;
+        const size_t split = this->work_split();
+        gnuradio::parallel_nary(
+            &multiply_items, output_items[0].cast<type *>(), &_ins[0], _ins.size(), n_nums,
+            _saturate.load(boost::memory_order_relaxed), split != 0 && noutput_items >= split, _chunk_ins
+        );
+        return noutput_items;
     }
-    return output_items[0].size();
-}
-
-/***********************************************************************
- * Multiplier implementation with float32 - calls volk
- **********************************************************************/
-template <>
-size_t multiply_generic<float>::get_work_multiple(void)
-{
-    return volk_get_alignment();
-}
 
-template <>
-int multiply_generic<float>::work(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t n_nums = output_items[0].size() * _vlen;
-    float *out = output_items[0].cast<float *>();
-    const float *in0 = input_items[0].cast<const float *>();
-
-    for (size_t n = 1; n < input_items.size(); n++){
-        const float *in = input_items[n].cast<const float *>();
-        volk_32f_x2_multiply_32f_a(out, in0, in, n_nums);
-        in0 = out; //for next input, we do output += input
-    }
-    return output_items[0].size();
-}
+private:
+    const size_t _vlen;
+    std::vector<const type *> _ins;
+    std::vector<const type *> _chunk_ins;
+    boost::atomic<bool> _saturate;
+};
 
 /***********************************************************************
  * factory function
@@ -145,15 +116,15 @@ multiply::sptr multiply::make_fc32_fc32(const size_t num_inputs, const size_t vl
 }
 
 multiply::sptr multiply::make_sc32_sc32(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new multiply_generic<int32_t>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new multiply_generic<std::complex<int32_t> >(num_inputs, vlen));
 }
 
 multiply::sptr multiply::make_sc16_sc16(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new multiply_generic<int16_t>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new multiply_generic<std::complex<int16_t> >(num_inputs, vlen));
 }
 
 multiply::sptr multiply::make_sc8_sc8(const size_t num_inputs, const size_t vlen){
-    return gnuradio::get_initial_sptr(new multiply_generic<int8_t>(num_inputs, 2*vlen));
+    return gnuradio::get_initial_sptr(new multiply_generic<std::complex<int8_t> >(num_inputs, vlen));
 }
 
 multiply::sptr multiply::make_f32_f32(const size_t num_inputs, const size_t vlen){
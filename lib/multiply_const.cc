@@ -50,6 +50,10 @@ public:
         return underlying_block->get_const().front();
     }
 
+    void set_saturate(const bool saturate){
+        underlying_block->set_saturate(saturate);
+    }
+
 private:
     multiply_const_v::sptr underlying_block;
 };
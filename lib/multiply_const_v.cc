@@ -21,12 +21,45 @@
 
 #include <gnuradio/extras/multiply_const.h>
 #include <gr_io_signature.h>
+#include <gruel/thread.h>
+#include <boost/atomic.hpp>
+#include "param_holder.h"
+#include "op_kernels.h"
 #include <stdexcept>
 #include <complex>
-#include <volk/volk.h>
 
 using namespace gnuradio::extras;
 
+/***********************************************************************
+ * Kernel selection, only the 8 and 16 bit integers have a Q7/Q15 mode
+ **********************************************************************/
+template <typename type>
+static void multiply_const_items(type *out, const type *in, const type *pattern, const size_t period, const size_t n, const bool){
+    gnuradio::kernels::multiply_periodic(out, in, pattern, period, n);
+}
+
+template <typename type>
+static void multiply_const_sat_items(type *out, const type *in, const type *pattern, const size_t period, const size_t n, const bool saturate){
+    if (saturate) gnuradio::kernels::multiply_sat_periodic(out, in, pattern, period, n);
+    else gnuradio::kernels::multiply_periodic(out, in, pattern, period, n);
+}
+
+static void multiply_const_items(int8_t *out, const int8_t *in, const int8_t *pattern, const size_t period, const size_t n, const bool saturate){
+    multiply_const_sat_items(out, in, pattern, period, n, saturate);
+}
+
+static void multiply_const_items(int16_t *out, const int16_t *in, const int16_t *pattern, const size_t period, const size_t n, const bool saturate){
+    multiply_const_sat_items(out, in, pattern, period, n, saturate);
+}
+
+static void multiply_const_items(std::complex<int8_t> *out, const std::complex<int8_t> *in, const std::complex<int8_t> *pattern, const size_t period, const size_t n, const bool saturate){
+    multiply_const_sat_items(out, in, pattern, period, n, saturate);
+}
+
+static void multiply_const_items(std::complex<int16_t> *out, const std::complex<int16_t> *in, const std::complex<int16_t> *pattern, const size_t period, const size_t n, const bool saturate){
+    multiply_const_sat_items(out, in, pattern, period, n, saturate);
+}
+
 /***********************************************************************
  * Generic multiply const implementation
  **********************************************************************/
@@ -38,130 +71,67 @@ public:
             "multiply const generic",
             gr_make_io_signature (1, 1, sizeof(type)*vec.size()),
             gr_make_io_signature (1, 1, sizeof(type)*vec.size())
-        )
+        ),
+        _vlen(vec.size()),
+        _saturate(false)
     {
-        _val.resize(vec.size());
         this->set_const(vec);
-        const int alignment_multiple = get_work_multiple() / (sizeof(type)*_val.size());
-        set_output_multiple(std::max(1, alignment_multiple));
+        this->set_inplace(true); //out[i] = f(in[i])
     }
 
-    size_t get_work_multiple(void);
-
-    int work1(
-        const InputItems &input_items,
-        const OutputItems &output_items
-    );
+    void set_saturate(const bool saturate){
+        _saturate.store(saturate, boost::memory_order_relaxed);
+    }
 
     int work(
         const InputItems &input_items,
         const OutputItems &output_items
     ){
-        if (_val.size() == 1) return work1(input_items, output_items);
-
+        //val is the repeated pattern, for any vlen including 1
+        const std::vector<type> &val = _val.get();
         const size_t noutput_items = output_items[0].size();
-        const size_t n_nums = noutput_items * _val.size();
+        const size_t n_nums = noutput_items * _vlen;
         type *out = output_items[0].cast<type *>();
         const type *in = input_items[0].cast<const type *>();
 
-        for (size_t i = 0; i < n_nums; i++){
-            out[i] = in[i] * _val[i%_val.size()];
-        }
+        multiply_const_items(out, in, &val[0], _vlen, n_nums, _saturate.load(boost::memory_order_relaxed));
 
         return noutput_items;
     }
 
     void _set_const(const std::vector<std::complex<double> > &val){
-        _original_val.assign(val.begin(), val.end());
-
-        if (val.size() != _val.size()){
+        if (val.size() != _vlen){
             throw std::invalid_argument("set_const called with the wrong length");
         }
+        gruel::scoped_lock l(_setter_mutex);
+        _original_val.assign(val.begin(), val.end());
+        _new_val.resize(_vlen);
         for (size_t i = 0; i < val.size(); i++){
-            gr_complex_double_to_num(val[i], _val[i]);
+            gr_complex_double_to_num(val[i], _new_val[i]);
         }
+
+        //repeat the constant into a pattern for the periodic kernels
+        _new_val.resize(gnuradio::kernels::pattern_length(_vlen));
+        for (size_t i = _vlen; i < _new_val.size(); i++){
+            _new_val[i] = _new_val[i - _vlen];
+        }
+        _val.set(_new_val);
     }
 
     std::vector<std::complex<double> > get_const(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _original_val;
     }
 
 private:
+    const size_t _vlen;
+    gnuradio::param_holder<std::vector<type> > _val;
+    gruel::mutex _setter_mutex;
     std::vector<std::complex<double> > _original_val;
-    std::vector<type> _val;
+    std::vector<type> _new_val;
+    boost::atomic<bool> _saturate;
 };
 
-/***********************************************************************
- * Generic vlen == 1 multiplier implementation
- **********************************************************************/
-template <typename type>
-size_t multiply_const_generic<type>::get_work_multiple(void)
-{
-    return 1;
-}
-
-template <typename type>
-int multiply_const_generic<type>::work1(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t noutput_items = output_items[0].size();
-    type *out = output_items[0].cast<type *>();
-    const type *in = input_items[0].cast<const type *>();
-
-    for (size_t i = 0; i < noutput_items; i++){
-        out[i] = in[i] * _val[0];
-    }
-
-    return noutput_items;
-}
-
-/***********************************************************************
- * FC32 vlen == 1 multiplier implementation
- **********************************************************************/
-template <>
-size_t multiply_const_generic<std::complex<float> >::get_work_multiple(void)
-{
-    return volk_get_alignment();
-}
-
-template <>
-int multiply_const_generic<std::complex<float> >::work1(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t num_items = output_items[0].size();
-    typedef std::complex<float> type;
-    const type scalar = reinterpret_cast<const type *>(&_val[0])[0];
-    type *out = output_items[0].cast<type *>();
-    const type *in = input_items[0].cast<const type *>();
-    volk_32fc_s32fc_multiply_32fc_a(out, in, scalar, num_items);
-    return num_items;
-}
-
-/***********************************************************************
- * F32 vlen == 1 multiplier implementation
- **********************************************************************/
-template <>
-size_t multiply_const_generic<float>::get_work_multiple(void)
-{
-    return volk_get_alignment();
-}
-
-template <>
-int multiply_const_generic<float>::work1(
-    const InputItems &input_items,
-    const OutputItems &output_items
-){
-    const size_t num_items = output_items[0].size();
-    typedef float type;
-    const type scalar = reinterpret_cast<const type *>(&_val[0])[0];
-    type *out = output_items[0].cast<type *>();
-    const type *in = input_items[0].cast<const type *>();
-    volk_32f_s32f_multiply_32f_a(out, in, scalar, num_items);
-    return num_items;
-}
-
 /***********************************************************************
  * factory function
  **********************************************************************/
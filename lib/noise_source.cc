@@ -22,6 +22,8 @@
 #include <gnuradio/extras/noise_source.h>
 #include <gr_io_signature.h>
 #include <gr_random.h>
+#include <gruel/thread.h>
+#include "param_holder.h"
 #include <stdexcept>
 #include <complex>
 #include <cmath>
@@ -34,6 +36,22 @@ static const size_t wave_table_size = 4096;
 /***********************************************************************
  * Generic add const implementation
  **********************************************************************/
+template <typename type>
+struct noise_table
+{
+    noise_table(const long seed):
+        table(wave_table_size), random(seed)
+    {
+        //NOP
+    }
+
+    std::vector<type> table;
+
+    //the generator state after making the table,
+    //work() continues the random stream from here
+    gr_random random;
+};
+
 template <typename type>
 class noise_source_impl : public noise_source{
 public:
@@ -43,11 +61,11 @@ public:
             gr_make_io_signature (0, 0, 0),
             gr_make_io_signature (1, 1, sizeof(type))
         ),
-        _index(0),
-        _table(wave_table_size),
+        _index(0), _random(seed),
+        _table(noise_table<type>(seed)),
+        _new_table(seed),
         _offset(0.0), _scalar(1.0), _factor(9.0),
-        _wave("GAUSSIAN"),
-        _random(seed)
+        _wave("GAUSSIAN")
     {
         this->update_table();
     }
@@ -56,88 +74,108 @@ public:
         const InputItems &input_items,
         const OutputItems &output_items
     ){
+        if (_table.update()) _random = _table.value().random;
+        const std::vector<type> &table = _table.value().table;
+
         _index += size_t(_random.ran1()*wave_table_size); //lookup into table is random each work()
 
         type *out = output_items[0].cast<type *>();
         for (size_t i = 0; i < output_items[0].size(); i++){
-            out[i] = _table[_index % wave_table_size];
+            out[i] = table[_index % wave_table_size];
             _index++;
         }
         return output_items[0].size();
     }
 
     void set_waveform(const std::string &wave){
+        gruel::scoped_lock l(_setter_mutex);
         _wave = wave;
         this->update_table();
     }
 
     std::string get_waveform(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _wave;
     }
 
     void set_offset(const std::complex<double> &offset){
+        gruel::scoped_lock l(_setter_mutex);
         _offset = offset;
         this->update_table();
     }
 
     std::complex<double> get_offset(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _offset;
     }
 
     void set_amplitude(const std::complex<double> &scalar){
+        gruel::scoped_lock l(_setter_mutex);
         _scalar = scalar;
         this->update_table();
     }
 
     std::complex<double> get_amplitude(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _scalar;
     }
 
     void set_factor(const double &factor){
+        gruel::scoped_lock l(_setter_mutex);
         _factor = factor;
         this->update_table();
     }
 
     double get_factor(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _factor;
     }
 
+    //! build the table from the settings and publish it, setter mutex held
     void update_table(void){
+        gr_random &random = _new_table.random;
+        const size_t size = _new_table.table.size();
         if (_wave == "UNIFORM"){
-            for (size_t i = 0; i < _table.size(); i++){
-                this->set_elem(i, std::complex<double>(2*_random.ran1()-1, 2*_random.ran1()-1));
+            for (size_t i = 0; i < size; i++){
+                this->set_elem(i, std::complex<double>(2*random.ran1()-1, 2*random.ran1()-1));
             }
         }
         else if (_wave == "GAUSSIAN"){
-            for (size_t i = 0; i < _table.size(); i++){
-                this->set_elem(i, std::complex<double>(_random.gasdev(), _random.gasdev()));
+            for (size_t i = 0; i < size; i++){
+                this->set_elem(i, std::complex<double>(random.gasdev(), random.gasdev()));
             }
         }
         else if (_wave == "LAPLACIAN"){
-            for (size_t i = 0; i < _table.size(); i++){
-                this->set_elem(i, std::complex<double>(_random.laplacian(), _random.laplacian()));
+            for (size_t i = 0; i < size; i++){
+                this->set_elem(i, std::complex<double>(random.laplacian(), random.laplacian()));
             }
         }
         else if (_wave == "IMPULSE"){
             const float factor = float(_factor);
-            for (size_t i = 0; i < _table.size(); i++){
-                this->set_elem(i, std::complex<double>(_random.impulse(factor), _random.impulse(factor)));
+            for (size_t i = 0; i < size; i++){
+                this->set_elem(i, std::complex<double>(random.impulse(factor), random.impulse(factor)));
             }
         }
         else throw std::invalid_argument("noise source got unknown wave type: " + _wave);
+        _table.set(_new_table);
     }
 
     inline void set_elem(const size_t index, const std::complex<double> &val){
-        gr_complex_double_to_num(_scalar * val + _offset, _table[index]);
+        gr_complex_double_to_num(_scalar * val + _offset, _new_table.table[index]);
     }
 
 private:
+    //work thread state
     size_t _index;
-    std::vector<type> _table;
+    gr_random _random;
+    gnuradio::param_holder<noise_table<type> > _table;
+
+    //setter state
+    gruel::mutex _setter_mutex;
+    noise_table<type> _new_table;
     std::complex<double> _offset, _scalar;
     double _factor;
     std::string _wave;
-    gr_random _random;
 };
 
 /***********************************************************************
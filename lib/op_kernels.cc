@@ -0,0 +1,194 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define EXTRAS_VEC_BYTES 16
+#include "op_kernels_simd.h"
+#include <cstdlib>
+#include <string>
+
+using namespace gnuradio::kernels;
+
+#ifdef HAVE_AVX2_KERNELS
+const kernel_table *extras_avx2_kernel_table(void);
+#endif
+
+/***********************************************************************
+ * Pick the kernels for this machine, once per process
+ **********************************************************************/
+static const kernel_table *pick_kernel_table(void)
+{
+    #if defined(__SSE2__) || defined(_M_X64)
+    static const kernel_table vec128 = make_kernel_table("sse2");
+    #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    static const kernel_table vec128 = make_kernel_table("neon");
+    #elif defined(EXTRAS_HAVE_VEC)
+    static const kernel_table vec128 = make_kernel_table("generic vector");
+    #else
+    static const kernel_table vec128 = make_kernel_table("scalar");
+    #endif
+
+    //EXTRAS_SIMD=generic turns off the wide kernels, to compare them
+    const char *simd = std::getenv("EXTRAS_SIMD");
+    if (simd != NULL && std::string(simd) == "generic") return &vec128;
+
+    #ifdef HAVE_AVX2_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return extras_avx2_kernel_table();
+    #endif
+
+    return &vec128;
+}
+
+static const kernel_table *active_kernels = pick_kernel_table();
+
+/***********************************************************************
+ * The public kernels, each is one call through the table
+ **********************************************************************/
+const char *gnuradio::kernels::simd_name(void)
+{
+    return active_kernels->name;
+}
+
+#define EXTRAS_DISPATCH_BINARY(name, entry, type) \
+    void gnuradio::kernels::name(type *out, const type *in0, const type *in1, const size_t n){ \
+        active_kernels->entry(out, in0, in1, n); \
+    }
+
+EXTRAS_DISPATCH_BINARY(add, add8, int8_t)
+EXTRAS_DISPATCH_BINARY(add, add16, int16_t)
+EXTRAS_DISPATCH_BINARY(add, add32, int32_t)
+EXTRAS_DISPATCH_BINARY(add, addf, float)
+EXTRAS_DISPATCH_BINARY(subtract, sub8, int8_t)
+EXTRAS_DISPATCH_BINARY(subtract, sub16, int16_t)
+EXTRAS_DISPATCH_BINARY(subtract, sub32, int32_t)
+EXTRAS_DISPATCH_BINARY(subtract, subf, float)
+EXTRAS_DISPATCH_BINARY(multiply, mul8, int8_t)
+EXTRAS_DISPATCH_BINARY(multiply, mul16, int16_t)
+EXTRAS_DISPATCH_BINARY(multiply, mul32, int32_t)
+EXTRAS_DISPATCH_BINARY(multiply, mulf, float)
+EXTRAS_DISPATCH_BINARY(multiply, mulc8, std::complex<int8_t>)
+EXTRAS_DISPATCH_BINARY(multiply, mulc16, std::complex<int16_t>)
+EXTRAS_DISPATCH_BINARY(multiply, mulc32, std::complex<int32_t>)
+EXTRAS_DISPATCH_BINARY(multiply, mulcf, std::complex<float>)
+EXTRAS_DISPATCH_BINARY(add_sat, addsat8, int8_t)
+EXTRAS_DISPATCH_BINARY(add_sat, addsat16, int16_t)
+EXTRAS_DISPATCH_BINARY(subtract_sat, subsat8, int8_t)
+EXTRAS_DISPATCH_BINARY(subtract_sat, subsat16, int16_t)
+EXTRAS_DISPATCH_BINARY(multiply_sat, mulq7, int8_t)
+EXTRAS_DISPATCH_BINARY(multiply_sat, mulq15, int16_t)
+EXTRAS_DISPATCH_BINARY(multiply_sat, mulcq7, std::complex<int8_t>)
+EXTRAS_DISPATCH_BINARY(multiply_sat, mulcq15, std::complex<int16_t>)
+
+#define EXTRAS_DISPATCH_UNARY(name, entry, type) \
+    void gnuradio::kernels::name(type *out, const type *in, const size_t n){ \
+        active_kernels->entry(out, in, n); \
+    }
+
+EXTRAS_DISPATCH_UNARY(negate, neg8, int8_t)
+EXTRAS_DISPATCH_UNARY(negate, neg16, int16_t)
+EXTRAS_DISPATCH_UNARY(negate, neg32, int32_t)
+EXTRAS_DISPATCH_UNARY(negate, negf, float)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcp8, int8_t)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcp16, int16_t)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcp32, int32_t)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcpf, float)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcpc8, std::complex<int8_t>)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcpc16, std::complex<int16_t>)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcpc32, std::complex<int32_t>)
+EXTRAS_DISPATCH_UNARY(reciprocal, rcpcf, std::complex<float>)
+EXTRAS_DISPATCH_UNARY(reciprocal_fast, rcpf_fast, float)
+EXTRAS_DISPATCH_UNARY(negate_sat, negsat8, int8_t)
+EXTRAS_DISPATCH_UNARY(negate_sat, negsat16, int16_t)
+
+#define EXTRAS_DISPATCH_NARY(name, entry, type) \
+    void gnuradio::kernels::name(type *out, const type *const *in, const size_t m, const size_t n){ \
+        active_kernels->entry(out, in, m, n); \
+    }
+
+EXTRAS_DISPATCH_NARY(add, addn8, int8_t)
+EXTRAS_DISPATCH_NARY(add, addn16, int16_t)
+EXTRAS_DISPATCH_NARY(add, addn32, int32_t)
+EXTRAS_DISPATCH_NARY(add, addnf, float)
+EXTRAS_DISPATCH_NARY(subtract, subn8, int8_t)
+EXTRAS_DISPATCH_NARY(subtract, subn16, int16_t)
+EXTRAS_DISPATCH_NARY(subtract, subn32, int32_t)
+EXTRAS_DISPATCH_NARY(subtract, subnf, float)
+EXTRAS_DISPATCH_NARY(multiply, muln8, int8_t)
+EXTRAS_DISPATCH_NARY(multiply, muln16, int16_t)
+EXTRAS_DISPATCH_NARY(multiply, muln32, int32_t)
+EXTRAS_DISPATCH_NARY(multiply, mulnf, float)
+EXTRAS_DISPATCH_NARY(multiply, mulnc8, std::complex<int8_t>)
+EXTRAS_DISPATCH_NARY(multiply, mulnc16, std::complex<int16_t>)
+EXTRAS_DISPATCH_NARY(multiply, mulnc32, std::complex<int32_t>)
+EXTRAS_DISPATCH_NARY(multiply, mulncf, std::complex<float>)
+EXTRAS_DISPATCH_NARY(divide, divn8, int8_t)
+EXTRAS_DISPATCH_NARY(divide, divn16, int16_t)
+EXTRAS_DISPATCH_NARY(divide, divn32, int32_t)
+EXTRAS_DISPATCH_NARY(divide, divnf, float)
+EXTRAS_DISPATCH_NARY(divide, divnc8, std::complex<int8_t>)
+EXTRAS_DISPATCH_NARY(divide, divnc16, std::complex<int16_t>)
+EXTRAS_DISPATCH_NARY(divide, divnc32, std::complex<int32_t>)
+EXTRAS_DISPATCH_NARY(divide, divncf, std::complex<float>)
+EXTRAS_DISPATCH_NARY(divide_fast, divnf_fast, float)
+EXTRAS_DISPATCH_NARY(add_sat, addnsat8, int8_t)
+EXTRAS_DISPATCH_NARY(add_sat, addnsat16, int16_t)
+EXTRAS_DISPATCH_NARY(subtract_sat, subnsat8, int8_t)
+EXTRAS_DISPATCH_NARY(subtract_sat, subnsat16, int16_t)
+EXTRAS_DISPATCH_NARY(multiply_sat, mulnq7, int8_t)
+EXTRAS_DISPATCH_NARY(multiply_sat, mulnq15, int16_t)
+EXTRAS_DISPATCH_NARY(multiply_sat, mulncq7, std::complex<int8_t>)
+EXTRAS_DISPATCH_NARY(multiply_sat, mulncq15, std::complex<int16_t>)
+
+#define EXTRAS_DISPATCH_CONVERT(entry, out_type, in_type) \
+    void gnuradio::kernels::convert(out_type *out, const in_type *in, const float scale, const size_t n){ \
+        active_kernels->entry(out, in, scale, n); \
+    }
+
+EXTRAS_DISPATCH_CONVERT(cvt8f, float, int8_t)
+EXTRAS_DISPATCH_CONVERT(cvt16f, float, int16_t)
+EXTRAS_DISPATCH_CONVERT(cvt32f, float, int32_t)
+EXTRAS_DISPATCH_CONVERT(cvtf8, int8_t, float)
+EXTRAS_DISPATCH_CONVERT(cvtf16, int16_t, float)
+EXTRAS_DISPATCH_CONVERT(cvtf32, int32_t, float)
+
+#define EXTRAS_DISPATCH_PERIODIC(name, entry, type) \
+    void gnuradio::kernels::name(type *out, const type *in, const type *pattern, const size_t period, const size_t n){ \
+        active_kernels->entry(out, in, pattern, period, n); \
+    }
+
+EXTRAS_DISPATCH_PERIODIC(add_periodic, addp8, int8_t)
+EXTRAS_DISPATCH_PERIODIC(add_periodic, addp16, int16_t)
+EXTRAS_DISPATCH_PERIODIC(add_periodic, addp32, int32_t)
+EXTRAS_DISPATCH_PERIODIC(add_periodic, addpf, float)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulp8, int8_t)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulp16, int16_t)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulp32, int32_t)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulpf, float)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulpc8, std::complex<int8_t>)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulpc16, std::complex<int16_t>)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulpc32, std::complex<int32_t>)
+EXTRAS_DISPATCH_PERIODIC(multiply_periodic, mulpcf, std::complex<float>)
+EXTRAS_DISPATCH_PERIODIC(add_sat_periodic, addpsat8, int8_t)
+EXTRAS_DISPATCH_PERIODIC(add_sat_periodic, addpsat16, int16_t)
+EXTRAS_DISPATCH_PERIODIC(multiply_sat_periodic, mulpq7, int8_t)
+EXTRAS_DISPATCH_PERIODIC(multiply_sat_periodic, mulpq15, int16_t)
+EXTRAS_DISPATCH_PERIODIC(multiply_sat_periodic, mulpcq7, std::complex<int8_t>)
+EXTRAS_DISPATCH_PERIODIC(multiply_sat_periodic, mulpcq15, std::complex<int16_t>)
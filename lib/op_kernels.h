@@ -0,0 +1,285 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_OP_KERNELS_H
+#define INCLUDED_GR_EXTRAS_OP_KERNELS_H
+
+#include <boost/cstdint.hpp>
+#include <complex>
+#include <cstddef>
+
+namespace gnuradio{ namespace kernels{
+
+/*!
+ * SIMD kernels for the arithmetic blocks.
+ *
+ * Each kernel has an overload for every type the op factories build.
+ * The kernels are picked once per process for the machine:
+ * AVX2 when the processor has it, otherwise 128 bit vectors,
+ * which is SSE2 on x86 and NEON on ARM.
+ *
+ * Integer arithmetic wraps like the plain C++ loops did.
+ * Buffers need no alignment, and the output may be one of the inputs.
+ */
+
+//! out[i] = in0[i] + in1[i]
+void add(int8_t *out, const int8_t *in0, const int8_t *in1, const size_t n);
+void add(int16_t *out, const int16_t *in0, const int16_t *in1, const size_t n);
+void add(int32_t *out, const int32_t *in0, const int32_t *in1, const size_t n);
+void add(float *out, const float *in0, const float *in1, const size_t n);
+
+//! out[i] = in0[i] - in1[i]
+void subtract(int8_t *out, const int8_t *in0, const int8_t *in1, const size_t n);
+void subtract(int16_t *out, const int16_t *in0, const int16_t *in1, const size_t n);
+void subtract(int32_t *out, const int32_t *in0, const int32_t *in1, const size_t n);
+void subtract(float *out, const float *in0, const float *in1, const size_t n);
+
+//! out[i] = -in[i]
+void negate(int8_t *out, const int8_t *in, const size_t n);
+void negate(int16_t *out, const int16_t *in, const size_t n);
+void negate(int32_t *out, const int32_t *in, const size_t n);
+void negate(float *out, const float *in, const size_t n);
+
+//! out[i] = in0[i] * in1[i], a complex multiply for the complex types
+void multiply(int8_t *out, const int8_t *in0, const int8_t *in1, const size_t n);
+void multiply(int16_t *out, const int16_t *in0, const int16_t *in1, const size_t n);
+void multiply(int32_t *out, const int32_t *in0, const int32_t *in1, const size_t n);
+void multiply(float *out, const float *in0, const float *in1, const size_t n);
+void multiply(std::complex<int8_t> *out, const std::complex<int8_t> *in0, const std::complex<int8_t> *in1, const size_t n);
+void multiply(std::complex<int16_t> *out, const std::complex<int16_t> *in0, const std::complex<int16_t> *in1, const size_t n);
+void multiply(std::complex<int32_t> *out, const std::complex<int32_t> *in0, const std::complex<int32_t> *in1, const size_t n);
+void multiply(std::complex<float> *out, const std::complex<float> *in0, const std::complex<float> *in1, const size_t n);
+
+/*!
+ * The N input kernels make one pass over the buffers.
+ * Each vector of output is folded from all m inputs in registers,
+ * then written once, so m inputs cost m reads and one write.
+ * Results match folding in input order: ((in[0] op in[1]) op in[2]) ...
+ * With m == 1 the output is a copy of in[0].
+ */
+
+//! out[i] = in[0][i] + in[1][i] + ... + in[m-1][i]
+void add(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void add(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void add(int32_t *out, const int32_t *const *in, const size_t m, const size_t n);
+void add(float *out, const float *const *in, const size_t m, const size_t n);
+
+//! out[i] = in[0][i] - in[1][i] - ... - in[m-1][i]
+void subtract(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void subtract(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void subtract(int32_t *out, const int32_t *const *in, const size_t m, const size_t n);
+void subtract(float *out, const float *const *in, const size_t m, const size_t n);
+
+//! out[i] = in[0][i] * in[1][i] * ... * in[m-1][i]
+void multiply(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void multiply(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void multiply(int32_t *out, const int32_t *const *in, const size_t m, const size_t n);
+void multiply(float *out, const float *const *in, const size_t m, const size_t n);
+void multiply(std::complex<int8_t> *out, const std::complex<int8_t> *const *in, const size_t m, const size_t n);
+void multiply(std::complex<int16_t> *out, const std::complex<int16_t> *const *in, const size_t m, const size_t n);
+void multiply(std::complex<int32_t> *out, const std::complex<int32_t> *const *in, const size_t m, const size_t n);
+void multiply(std::complex<float> *out, const std::complex<float> *const *in, const size_t m, const size_t n);
+
+/*!
+ * Complex division is a*conj(b) / |b|^2, without the rescaling that
+ * std::complex does, so |b|^2 must fit the type.
+ * The integer types compute it one size wider and truncate the quotient.
+ * Integer division by zero is undefined, like the plain C++ loops.
+ */
+
+//! out[i] = in[0][i] / in[1][i] / ... / in[m-1][i]
+void divide(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void divide(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void divide(int32_t *out, const int32_t *const *in, const size_t m, const size_t n);
+void divide(float *out, const float *const *in, const size_t m, const size_t n);
+void divide(std::complex<int8_t> *out, const std::complex<int8_t> *const *in, const size_t m, const size_t n);
+void divide(std::complex<int16_t> *out, const std::complex<int16_t> *const *in, const size_t m, const size_t n);
+void divide(std::complex<int32_t> *out, const std::complex<int32_t> *const *in, const size_t m, const size_t n);
+void divide(std::complex<float> *out, const std::complex<float> *const *in, const size_t m, const size_t n);
+
+//! out[i] = 1 / in[i]
+void reciprocal(int8_t *out, const int8_t *in, const size_t n);
+void reciprocal(int16_t *out, const int16_t *in, const size_t n);
+void reciprocal(int32_t *out, const int32_t *in, const size_t n);
+void reciprocal(float *out, const float *in, const size_t n);
+void reciprocal(std::complex<int8_t> *out, const std::complex<int8_t> *in, const size_t n);
+void reciprocal(std::complex<int16_t> *out, const std::complex<int16_t> *in, const size_t n);
+void reciprocal(std::complex<int32_t> *out, const std::complex<int32_t> *in, const size_t n);
+void reciprocal(std::complex<float> *out, const std::complex<float> *in, const size_t n);
+
+/*!
+ * Fast float division, a times the reciprocal of b.
+ * On AVX the reciprocal is the estimate plus one Newton step,
+ * which is within a few ulp of exact division, elsewhere it is exact.
+ * Divisors must be finite and non zero, zero gives NaN, not inf.
+ */
+void divide_fast(float *out, const float *const *in, const size_t m, const size_t n);
+void reciprocal_fast(float *out, const float *in, const size_t n);
+
+/*!
+ * Saturating fixed point kernels for the 8 and 16 bit types.
+ * Sums and differences clamp to the range of the type instead of wrapping.
+ * Products are Q7 or Q15 fractions: (a*b + half) >> 7 or 15, rounded
+ * and clamped, so 0x4000 * 0x4000 = 0x2000 and -1.0 * -1.0 is the max.
+ * Complex products round and clamp the real and imaginary parts.
+ */
+
+//! out[i] = in0[i] + in1[i], saturated
+void add_sat(int8_t *out, const int8_t *in0, const int8_t *in1, const size_t n);
+void add_sat(int16_t *out, const int16_t *in0, const int16_t *in1, const size_t n);
+
+//! out[i] = in0[i] - in1[i], saturated
+void subtract_sat(int8_t *out, const int8_t *in0, const int8_t *in1, const size_t n);
+void subtract_sat(int16_t *out, const int16_t *in0, const int16_t *in1, const size_t n);
+
+//! out[i] = -in[i], saturated
+void negate_sat(int8_t *out, const int8_t *in, const size_t n);
+void negate_sat(int16_t *out, const int16_t *in, const size_t n);
+
+//! out[i] = in0[i] * in1[i] in Q7 or Q15
+void multiply_sat(int8_t *out, const int8_t *in0, const int8_t *in1, const size_t n);
+void multiply_sat(int16_t *out, const int16_t *in0, const int16_t *in1, const size_t n);
+void multiply_sat(std::complex<int8_t> *out, const std::complex<int8_t> *in0, const std::complex<int8_t> *in1, const size_t n);
+void multiply_sat(std::complex<int16_t> *out, const std::complex<int16_t> *in0, const std::complex<int16_t> *in1, const size_t n);
+
+//! N input forms, folded in input order like the wrapping kernels
+void add_sat(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void add_sat(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void subtract_sat(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void subtract_sat(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void multiply_sat(int8_t *out, const int8_t *const *in, const size_t m, const size_t n);
+void multiply_sat(int16_t *out, const int16_t *const *in, const size_t m, const size_t n);
+void multiply_sat(std::complex<int8_t> *out, const std::complex<int8_t> *const *in, const size_t m, const size_t n);
+void multiply_sat(std::complex<int16_t> *out, const std::complex<int16_t> *const *in, const size_t m, const size_t n);
+
+/*!
+ * Convert between the integer types and float: out[i] = in[i] * scale.
+ * Integer outputs round to nearest, ties to even, and clamp to the
+ * range of the type, NaN gives the most negative value.
+ * Complex items convert as their interleaved lanes, with 2n.
+ */
+void convert(float *out, const int8_t *in, const float scale, const size_t n);
+void convert(float *out, const int16_t *in, const float scale, const size_t n);
+void convert(float *out, const int32_t *in, const float scale, const size_t n);
+void convert(int8_t *out, const float *in, const float scale, const size_t n);
+void convert(int16_t *out, const float *in, const float scale, const size_t n);
+void convert(int32_t *out, const float *in, const float scale, const size_t n);
+
+//! Complex add, subtract and negate work on the interleaved lanes
+template <typename T>
+inline void add(std::complex<T> *out, const std::complex<T> *in0, const std::complex<T> *in1, const size_t n)
+{
+    add(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in0), reinterpret_cast<const T *>(in1), 2*n);
+}
+
+template <typename T>
+inline void subtract(std::complex<T> *out, const std::complex<T> *in0, const std::complex<T> *in1, const size_t n)
+{
+    subtract(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in0), reinterpret_cast<const T *>(in1), 2*n);
+}
+
+template <typename T>
+inline void negate(std::complex<T> *out, const std::complex<T> *in, const size_t n)
+{
+    negate(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in), 2*n);
+}
+
+template <typename T>
+inline void add_sat(std::complex<T> *out, const std::complex<T> *in0, const std::complex<T> *in1, const size_t n)
+{
+    add_sat(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in0), reinterpret_cast<const T *>(in1), 2*n);
+}
+
+template <typename T>
+inline void subtract_sat(std::complex<T> *out, const std::complex<T> *in0, const std::complex<T> *in1, const size_t n)
+{
+    subtract_sat(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in0), reinterpret_cast<const T *>(in1), 2*n);
+}
+
+template <typename T>
+inline void negate_sat(std::complex<T> *out, const std::complex<T> *in, const size_t n)
+{
+    negate_sat(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in), 2*n);
+}
+
+/*!
+ * Periodic kernels apply a constant vector of length vlen to every item.
+ * The blocks repeat the constant once, when it is set, into a pattern
+ * of pattern_length(vlen) elements: whole items, and whole vectors
+ * when that stays short, and pass vlen as the period.
+ * When whole periods fill one to eight SIMD registers, the kernels
+ * load the pattern into registers once and stream the input past it.
+ * Other periods walk the buffer one pattern at a time,
+ * so the inner loops are still the plain streaming loops,
+ * with no index arithmetic per element.
+ */
+inline size_t pattern_length(const size_t vlen)
+{
+    size_t len = ((1024 + vlen - 1)/vlen)*vlen;
+    while (len % 64 != 0 && len < 4096) len += vlen;
+    return len;
+}
+
+//! out[i] = in[i] + pattern[i % period]
+void add_periodic(int8_t *out, const int8_t *in, const int8_t *pattern, const size_t period, const size_t n);
+void add_periodic(int16_t *out, const int16_t *in, const int16_t *pattern, const size_t period, const size_t n);
+void add_periodic(int32_t *out, const int32_t *in, const int32_t *pattern, const size_t period, const size_t n);
+void add_periodic(float *out, const float *in, const float *pattern, const size_t period, const size_t n);
+
+//! out[i] = in[i] * pattern[i % period]
+void multiply_periodic(int8_t *out, const int8_t *in, const int8_t *pattern, const size_t period, const size_t n);
+void multiply_periodic(int16_t *out, const int16_t *in, const int16_t *pattern, const size_t period, const size_t n);
+void multiply_periodic(int32_t *out, const int32_t *in, const int32_t *pattern, const size_t period, const size_t n);
+void multiply_periodic(float *out, const float *in, const float *pattern, const size_t period, const size_t n);
+void multiply_periodic(std::complex<int8_t> *out, const std::complex<int8_t> *in, const std::complex<int8_t> *pattern, const size_t period, const size_t n);
+void multiply_periodic(std::complex<int16_t> *out, const std::complex<int16_t> *in, const std::complex<int16_t> *pattern, const size_t period, const size_t n);
+void multiply_periodic(std::complex<int32_t> *out, const std::complex<int32_t> *in, const std::complex<int32_t> *pattern, const size_t period, const size_t n);
+void multiply_periodic(std::complex<float> *out, const std::complex<float> *in, const std::complex<float> *pattern, const size_t period, const size_t n);
+
+//! out[i] = in[i] + pattern[i % period], saturated
+void add_sat_periodic(int8_t *out, const int8_t *in, const int8_t *pattern, const size_t period, const size_t n);
+void add_sat_periodic(int16_t *out, const int16_t *in, const int16_t *pattern, const size_t period, const size_t n);
+
+//! out[i] = in[i] * pattern[i % period] in Q7 or Q15
+void multiply_sat_periodic(int8_t *out, const int8_t *in, const int8_t *pattern, const size_t period, const size_t n);
+void multiply_sat_periodic(int16_t *out, const int16_t *in, const int16_t *pattern, const size_t period, const size_t n);
+void multiply_sat_periodic(std::complex<int8_t> *out, const std::complex<int8_t> *in, const std::complex<int8_t> *pattern, const size_t period, const size_t n);
+void multiply_sat_periodic(std::complex<int16_t> *out, const std::complex<int16_t> *in, const std::complex<int16_t> *pattern, const size_t period, const size_t n);
+
+//! Complex periodic adds work on the interleaved lanes
+template <typename T>
+inline void add_periodic(std::complex<T> *out, const std::complex<T> *in, const std::complex<T> *pattern, const size_t period, const size_t n)
+{
+    add_periodic(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in), reinterpret_cast<const T *>(pattern), 2*period, 2*n);
+}
+
+template <typename T>
+inline void add_sat_periodic(std::complex<T> *out, const std::complex<T> *in, const std::complex<T> *pattern, const size_t period, const size_t n)
+{
+    add_sat_periodic(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in), reinterpret_cast<const T *>(pattern), 2*period, 2*n);
+}
+
+//! The name of the instruction set in use, for benchmarks and logs
+const char *simd_name(void);
+
+}} //namespace gnuradio::kernels
+
+#endif /* INCLUDED_GR_EXTRAS_OP_KERNELS_H */
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define EXTRAS_VEC_BYTES 32
+#include "op_kernels_simd.h"
+
+/***********************************************************************
+ * This file is built with -mavx2, the dispatcher in op_kernels.cc
+ * only calls into it when the processor supports AVX2.
+ **********************************************************************/
+const gnuradio::kernels::kernel_table *extras_avx2_kernel_table(void)
+{
+    static const gnuradio::kernels::kernel_table table = make_kernel_table("avx2");
+    return &table;
+}
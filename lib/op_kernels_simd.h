@@ -0,0 +1,1339 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/***********************************************************************
+ * The kernel loops, written once for every vector width.
+ *
+ * Include after defining EXTRAS_VEC_BYTES, the vector size in bytes.
+ * The translation unit decides the instruction set with its flags,
+ * and the GCC vector extensions turn into those instructions.
+ * Everything is file-local, so each width gets its own copy.
+ **********************************************************************/
+
+#ifndef INCLUDED_GR_EXTRAS_OP_KERNELS_SIMD_H
+#define INCLUDED_GR_EXTRAS_OP_KERNELS_SIMD_H
+
+#include "op_kernels.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+namespace gnuradio{ namespace kernels{
+
+//! The kernels for one instruction set
+struct kernel_table
+{
+    const char *name;
+    void (*add8)(int8_t *, const int8_t *, const int8_t *, const size_t);
+    void (*add16)(int16_t *, const int16_t *, const int16_t *, const size_t);
+    void (*add32)(int32_t *, const int32_t *, const int32_t *, const size_t);
+    void (*addf)(float *, const float *, const float *, const size_t);
+    void (*sub8)(int8_t *, const int8_t *, const int8_t *, const size_t);
+    void (*sub16)(int16_t *, const int16_t *, const int16_t *, const size_t);
+    void (*sub32)(int32_t *, const int32_t *, const int32_t *, const size_t);
+    void (*subf)(float *, const float *, const float *, const size_t);
+    void (*neg8)(int8_t *, const int8_t *, const size_t);
+    void (*neg16)(int16_t *, const int16_t *, const size_t);
+    void (*neg32)(int32_t *, const int32_t *, const size_t);
+    void (*negf)(float *, const float *, const size_t);
+    void (*mul8)(int8_t *, const int8_t *, const int8_t *, const size_t);
+    void (*mul16)(int16_t *, const int16_t *, const int16_t *, const size_t);
+    void (*mul32)(int32_t *, const int32_t *, const int32_t *, const size_t);
+    void (*mulf)(float *, const float *, const float *, const size_t);
+    void (*mulc8)(std::complex<int8_t> *, const std::complex<int8_t> *, const std::complex<int8_t> *, const size_t);
+    void (*mulc16)(std::complex<int16_t> *, const std::complex<int16_t> *, const std::complex<int16_t> *, const size_t);
+    void (*mulc32)(std::complex<int32_t> *, const std::complex<int32_t> *, const std::complex<int32_t> *, const size_t);
+    void (*mulcf)(std::complex<float> *, const std::complex<float> *, const std::complex<float> *, const size_t);
+    void (*addn8)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*addn16)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*addn32)(int32_t *, const int32_t *const *, const size_t, const size_t);
+    void (*addnf)(float *, const float *const *, const size_t, const size_t);
+    void (*subn8)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*subn16)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*subn32)(int32_t *, const int32_t *const *, const size_t, const size_t);
+    void (*subnf)(float *, const float *const *, const size_t, const size_t);
+    void (*muln8)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*muln16)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*muln32)(int32_t *, const int32_t *const *, const size_t, const size_t);
+    void (*mulnf)(float *, const float *const *, const size_t, const size_t);
+    void (*mulnc8)(std::complex<int8_t> *, const std::complex<int8_t> *const *, const size_t, const size_t);
+    void (*mulnc16)(std::complex<int16_t> *, const std::complex<int16_t> *const *, const size_t, const size_t);
+    void (*mulnc32)(std::complex<int32_t> *, const std::complex<int32_t> *const *, const size_t, const size_t);
+    void (*mulncf)(std::complex<float> *, const std::complex<float> *const *, const size_t, const size_t);
+    void (*divn8)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*divn16)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*divn32)(int32_t *, const int32_t *const *, const size_t, const size_t);
+    void (*divnf)(float *, const float *const *, const size_t, const size_t);
+    void (*divnc8)(std::complex<int8_t> *, const std::complex<int8_t> *const *, const size_t, const size_t);
+    void (*divnc16)(std::complex<int16_t> *, const std::complex<int16_t> *const *, const size_t, const size_t);
+    void (*divnc32)(std::complex<int32_t> *, const std::complex<int32_t> *const *, const size_t, const size_t);
+    void (*divncf)(std::complex<float> *, const std::complex<float> *const *, const size_t, const size_t);
+    void (*rcp8)(int8_t *, const int8_t *, const size_t);
+    void (*rcp16)(int16_t *, const int16_t *, const size_t);
+    void (*rcp32)(int32_t *, const int32_t *, const size_t);
+    void (*rcpf)(float *, const float *, const size_t);
+    void (*rcpc8)(std::complex<int8_t> *, const std::complex<int8_t> *, const size_t);
+    void (*rcpc16)(std::complex<int16_t> *, const std::complex<int16_t> *, const size_t);
+    void (*rcpc32)(std::complex<int32_t> *, const std::complex<int32_t> *, const size_t);
+    void (*rcpcf)(std::complex<float> *, const std::complex<float> *, const size_t);
+    void (*divnf_fast)(float *, const float *const *, const size_t, const size_t);
+    void (*rcpf_fast)(float *, const float *, const size_t);
+    void (*addsat8)(int8_t *, const int8_t *, const int8_t *, const size_t);
+    void (*addsat16)(int16_t *, const int16_t *, const int16_t *, const size_t);
+    void (*subsat8)(int8_t *, const int8_t *, const int8_t *, const size_t);
+    void (*subsat16)(int16_t *, const int16_t *, const int16_t *, const size_t);
+    void (*negsat8)(int8_t *, const int8_t *, const size_t);
+    void (*negsat16)(int16_t *, const int16_t *, const size_t);
+    void (*mulq7)(int8_t *, const int8_t *, const int8_t *, const size_t);
+    void (*mulq15)(int16_t *, const int16_t *, const int16_t *, const size_t);
+    void (*mulcq7)(std::complex<int8_t> *, const std::complex<int8_t> *, const std::complex<int8_t> *, const size_t);
+    void (*mulcq15)(std::complex<int16_t> *, const std::complex<int16_t> *, const std::complex<int16_t> *, const size_t);
+    void (*addnsat8)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*addnsat16)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*subnsat8)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*subnsat16)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*mulnq7)(int8_t *, const int8_t *const *, const size_t, const size_t);
+    void (*mulnq15)(int16_t *, const int16_t *const *, const size_t, const size_t);
+    void (*mulncq7)(std::complex<int8_t> *, const std::complex<int8_t> *const *, const size_t, const size_t);
+    void (*mulncq15)(std::complex<int16_t> *, const std::complex<int16_t> *const *, const size_t, const size_t);
+    void (*cvt8f)(float *, const int8_t *, const float, const size_t);
+    void (*cvt16f)(float *, const int16_t *, const float, const size_t);
+    void (*cvt32f)(float *, const int32_t *, const float, const size_t);
+    void (*cvtf8)(int8_t *, const float *, const float, const size_t);
+    void (*cvtf16)(int16_t *, const float *, const float, const size_t);
+    void (*cvtf32)(int32_t *, const float *, const float, const size_t);
+    void (*addp8)(int8_t *, const int8_t *, const int8_t *, const size_t, const size_t);
+    void (*addp16)(int16_t *, const int16_t *, const int16_t *, const size_t, const size_t);
+    void (*addp32)(int32_t *, const int32_t *, const int32_t *, const size_t, const size_t);
+    void (*addpf)(float *, const float *, const float *, const size_t, const size_t);
+    void (*mulp8)(int8_t *, const int8_t *, const int8_t *, const size_t, const size_t);
+    void (*mulp16)(int16_t *, const int16_t *, const int16_t *, const size_t, const size_t);
+    void (*mulp32)(int32_t *, const int32_t *, const int32_t *, const size_t, const size_t);
+    void (*mulpf)(float *, const float *, const float *, const size_t, const size_t);
+    void (*mulpc8)(std::complex<int8_t> *, const std::complex<int8_t> *, const std::complex<int8_t> *, const size_t, const size_t);
+    void (*mulpc16)(std::complex<int16_t> *, const std::complex<int16_t> *, const std::complex<int16_t> *, const size_t, const size_t);
+    void (*mulpc32)(std::complex<int32_t> *, const std::complex<int32_t> *, const std::complex<int32_t> *, const size_t, const size_t);
+    void (*mulpcf)(std::complex<float> *, const std::complex<float> *, const std::complex<float> *, const size_t, const size_t);
+    void (*addpsat8)(int8_t *, const int8_t *, const int8_t *, const size_t, const size_t);
+    void (*addpsat16)(int16_t *, const int16_t *, const int16_t *, const size_t, const size_t);
+    void (*mulpq7)(int8_t *, const int8_t *, const int8_t *, const size_t, const size_t);
+    void (*mulpq15)(int16_t *, const int16_t *, const int16_t *, const size_t, const size_t);
+    void (*mulpcq7)(std::complex<int8_t> *, const std::complex<int8_t> *, const std::complex<int8_t> *, const size_t, const size_t);
+    void (*mulpcq15)(std::complex<int16_t> *, const std::complex<int16_t> *, const std::complex<int16_t> *, const size_t, const size_t);
+};
+
+}} //namespace gnuradio::kernels
+
+#if defined(__GNUC__) && defined(EXTRAS_VEC_BYTES)
+#define EXTRAS_HAVE_VEC
+#endif
+
+//the complex multiply swaps the halves of a pair with shifts
+#if defined(EXTRAS_HAVE_VEC) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define EXTRAS_HAVE_VEC_COMPLEX
+#endif
+
+//x86 has packed saturating add, subtract and Q15 multiply
+#if defined(EXTRAS_HAVE_VEC_COMPLEX) && EXTRAS_VEC_BYTES == 32 && defined(__AVX2__)
+#include <immintrin.h>
+#define EXTRAS_X86_SAT 256
+#elif defined(EXTRAS_HAVE_VEC_COMPLEX) && EXTRAS_VEC_BYTES == 16 && defined(__SSE2__)
+#include <emmintrin.h>
+#define EXTRAS_X86_SAT 128
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#endif
+
+namespace{
+
+#ifdef EXTRAS_HAVE_VEC
+static const bool vec_enabled = true;
+#else
+static const bool vec_enabled = false;
+#endif
+
+/***********************************************************************
+ * Element wise operations, the same for scalars and vectors.
+ * The integer kernels use unsigned types, which wrap without UB,
+ * and the small ones are multiplied as unsigned int to avoid promotion.
+ * Ops with vector set to false only run the scalar loop.
+ **********************************************************************/
+struct add_op
+{
+    static const bool vector = vec_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return T(a + b);}
+};
+
+struct sub_op
+{
+    static const bool vector = vec_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return T(a - b);}
+};
+
+struct mul_op
+{
+    static const bool vector = vec_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return T(a * b);}
+    uint8_t operator()(const uint8_t a, const uint8_t b) const {return uint8_t(unsigned(a) * b);}
+    uint16_t operator()(const uint16_t a, const uint16_t b) const {return uint16_t(unsigned(a) * b);}
+};
+
+//! division is done on the signed types
+struct div_op
+{
+    static const bool vector = vec_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return T(a / b);}
+    template <typename T> T rcp(const T &a) const {return T((T() + 1) / a);}
+};
+
+struct neg_op
+{
+    static const bool vector = vec_enabled;
+    template <typename T> T operator()(const T &a) const {return T(-a);}
+};
+
+//! out = 1/in with the reciprocal of a division op
+template <typename Div>
+struct rcp_op
+{
+    static const bool vector = Div::vector;
+    template <typename T> T operator()(const T &a) const {return Div().rcp(a);}
+};
+
+//! The lane type of an item, the element for complex items
+template <typename T> struct lane_of
+{
+    typedef T type;
+};
+
+template <typename T> struct lane_of<std::complex<T> >
+{
+    typedef T type;
+};
+
+#ifdef EXTRAS_HAVE_VEC
+template <typename T> struct vec_of
+{
+    typedef T type __attribute__((vector_size(EXTRAS_VEC_BYTES)));
+};
+
+//unaligned load and store, the compiler makes these one instruction
+template <typename V> inline V vec_load(const void *p)
+{
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template <typename V> inline void vec_store(void *p, const V &v)
+{
+    std::memcpy(p, &v, sizeof(V));
+}
+#endif
+
+/***********************************************************************
+ * Complex multiply on interleaved pairs.
+ * T is the element type, P is the unsigned type of a whole pair.
+ * With a = (ar, ai) and b = (br, bi) in each pair:
+ *   p1 = a*b        = (ar*br, ai*bi)
+ *   p2 = a*swap(b)  = (ar*bi, ai*br)
+ * The real part is p1.lo - p1.hi, the imaginary part is p2.lo + p2.hi.
+ * Moving the high half down is a shift of the pair,
+ * so the whole thing is a handful of vertical operations.
+ **********************************************************************/
+template <typename T, typename P>
+struct complex_mul_op
+{
+    #ifdef EXTRAS_HAVE_VEC_COMPLEX
+    static const bool vector = true;
+    typedef typename vec_of<T>::type V;
+    typedef typename vec_of<P>::type PV;
+
+    V operator()(const V &a, const V &b) const
+    {
+        const int shift = 8*sizeof(T);
+        const PV lo_mask = PV() + P(P(~P(0)) >> shift);
+        const V b_swap = (V)(((PV)b << shift) | ((PV)b >> shift));
+        const V p1 = a*b;
+        const V p2 = a*b_swap;
+        const V re = p1 - (V)((PV)p1 >> shift);
+        const V im = p2 + (V)((PV)p2 >> shift);
+        return (V)(((PV)re & lo_mask) | ((PV)im << shift));
+    }
+    #else
+    static const bool vector = false;
+    #endif
+
+    std::complex<T> operator()(const std::complex<T> &a, const std::complex<T> &b) const
+    {
+        const mul_op mul;
+        return std::complex<T>(
+            T(mul(a.real(), b.real()) - mul(a.imag(), b.imag())),
+            T(mul(a.real(), b.imag()) + mul(a.imag(), b.real()))
+        );
+    }
+};
+
+/***********************************************************************
+ * Complex division with the plain formula a*conj(b) / |b|^2.
+ * The integer types work in a wider type W and truncate like C++.
+ * The float type uses the same swaps as the multiply,
+ * with the Div op for the final division by |b|^2.
+ * Scalar and vector items get the same formula, so results do not
+ * depend on where an item falls in the buffer.
+ **********************************************************************/
+template <typename T, typename W>
+struct complex_int_div_op
+{
+    static const bool vector = false;
+
+    std::complex<T> operator()(const std::complex<T> &a, const std::complex<T> &b) const
+    {
+        const W ar = a.real(), ai = a.imag(), br = b.real(), bi = b.imag();
+        const W mag = br*br + bi*bi;
+        return std::complex<T>(T((ar*br + ai*bi)/mag), T((ai*br - ar*bi)/mag));
+    }
+
+    std::complex<T> rcp(const std::complex<T> &b) const
+    {
+        return (*this)(std::complex<T>(1), b);
+    }
+};
+
+template <typename Div>
+struct complex_float_div_op
+{
+    #ifdef EXTRAS_HAVE_VEC_COMPLEX
+    static const bool vector = Div::vector;
+    typedef vec_of<float>::type V;
+    typedef vec_of<uint64_t>::type PV;
+
+    static V swap(const V &v)
+    {
+        return (V)(((PV)v << 32) | ((PV)v >> 32));
+    }
+
+    V operator()(const V &a, const V &b) const
+    {
+        const PV lo_mask = PV() + uint64_t(0xffffffff);
+        const V p1 = a*b;       //(ar*br, ai*bi)
+        const V p2 = a*swap(b); //(ar*bi, ai*br)
+        const V mm = b*b;       //(br*br, bi*bi)
+        const V re = p1 + (V)((PV)p1 >> 32); //low lane is the real part
+        const V im = p2 - (V)((PV)p2 << 32); //high lane is the imag part
+        const V num = (V)(((PV)re & lo_mask) | ((PV)im & ~lo_mask));
+        return Div()(num, mm + swap(mm));
+    }
+
+    V rcp(const V &b) const
+    {
+        const V one = (V)(PV() + uint64_t(0x3f800000)); //(1.0f, 0.0f) pairs
+        return (*this)(one, b);
+    }
+    #else
+    static const bool vector = false;
+    #endif
+
+    std::complex<float> operator()(const std::complex<float> &a, const std::complex<float> &b) const
+    {
+        const float ar = a.real(), ai = a.imag(), br = b.real(), bi = b.imag();
+        const float mag = br*br + bi*bi;
+        return std::complex<float>(Div()(ar*br + ai*bi, mag), Div()(ai*br - ar*bi, mag));
+    }
+
+    std::complex<float> rcp(const std::complex<float> &b) const
+    {
+        return (*this)(std::complex<float>(1), b);
+    }
+};
+
+/***********************************************************************
+ * Fast float division: a * (1/b) from a reciprocal estimate.
+ * The 12 bit estimate gets one Newton step, r' = r*(2 - b*r),
+ * which leaves it within a few ulp of 1/b.
+ * Zero and infinite divisors make NaN instead of inf and zero.
+ * Only AVX uses the estimate: the 128 bit divider is about as fast
+ * as estimate plus refinement, so everything else divides exactly,
+ * and so do the scalar tails.
+ **********************************************************************/
+#if defined(EXTRAS_HAVE_VEC) && EXTRAS_VEC_BYTES == 32 && defined(__AVX__)
+#define EXTRAS_RCP_ESTIMATE(v) __builtin_ia32_rcpps256(v)
+#endif
+
+struct div_fast_op
+{
+    static const bool vector = vec_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return a / b;}
+    template <typename T> T rcp(const T &a) const {return 1.0f / a;}
+
+    #ifdef EXTRAS_RCP_ESTIMATE
+    typedef vec_of<float>::type V;
+
+    V operator()(const V &a, const V &b) const {return a * this->rcp(b);}
+
+    V rcp(const V &b) const
+    {
+        const V r = EXTRAS_RCP_ESTIMATE(b);
+        return r*(2.0f - b*r);
+    }
+    #endif
+};
+
+/***********************************************************************
+ * Saturating fixed point for the 8 and 16 bit types.
+ * Sums clamp to the range of the lane instead of wrapping.
+ * Products are rounded Q7 or Q15 fractions, (a*b + half) >> bits,
+ * clamped, so -1.0 times -1.0 gives the largest value, not -1.0.
+ * x86 uses the packed saturating instructions where there is one,
+ * otherwise each pair of lanes is widened into one wide lane.
+ **********************************************************************/
+template <typename T> struct fixed_traits;
+
+template <> struct fixed_traits<int8_t>
+{
+    typedef uint8_t unsigned_type;
+    typedef int16_t wide_type;
+    typedef uint16_t unsigned_wide_type;
+    static const int bits = 7;
+    static const int min = -128;
+    static const int max = 127;
+};
+
+template <> struct fixed_traits<int16_t>
+{
+    typedef uint16_t unsigned_type;
+    typedef int32_t wide_type;
+    typedef uint32_t unsigned_wide_type;
+    static const int bits = 15;
+    static const int min = -32768;
+    static const int max = 32767;
+};
+
+template <typename T> inline T clamp_fixed(const long long v)
+{
+    return T(std::min<long long>(std::max<long long>(v, fixed_traits<T>::min), fixed_traits<T>::max));
+}
+
+template <typename T> inline T add_sat_of(const T a, const T b)
+{
+    return clamp_fixed<T>((long long)(a) + b);
+}
+
+template <typename T> inline T sub_sat_of(const T a, const T b)
+{
+    return clamp_fixed<T>((long long)(a) - b);
+}
+
+template <typename T> inline T mul_fixed_of(const T a, const T b)
+{
+    const int bits = fixed_traits<T>::bits;
+    return clamp_fixed<T>(((long long)(a)*b + (1 << (bits-1))) >> bits);
+}
+
+template <typename T> inline std::complex<T> mul_fixed_of(const std::complex<T> &a, const std::complex<T> &b)
+{
+    const int bits = fixed_traits<T>::bits;
+    const long long ar = a.real(), ai = a.imag(), br = b.real(), bi = b.imag();
+    return std::complex<T>(
+        clamp_fixed<T>((ar*br - ai*bi + (1 << (bits-1))) >> bits),
+        clamp_fixed<T>((ar*bi + ai*br + (1 << (bits-1))) >> bits)
+    );
+}
+
+#ifdef EXTRAS_HAVE_VEC_COMPLEX
+static const bool vec_fixed_enabled = true;
+
+//! V is the vector of T lanes, W holds the same bits as wide lanes
+template <typename T> struct fixed_vecs
+{
+    typedef typename vec_of<T>::type V;
+    typedef typename vec_of<typename fixed_traits<T>::unsigned_type>::type UV;
+    typedef typename vec_of<typename fixed_traits<T>::wide_type>::type W;
+    typedef typename vec_of<typename fixed_traits<T>::unsigned_wide_type>::type UW;
+};
+
+//overflow happened where the sign of the result is wrong,
+//the saturated value is the largest value with the sign of a
+template <typename T> inline typename fixed_vecs<T>::V vec_add_sat(
+    const typename fixed_vecs<T>::V &a, const typename fixed_vecs<T>::V &b
+){
+    typedef typename fixed_vecs<T>::V V;
+    typedef typename fixed_vecs<T>::UV UV;
+    const int sign = 8*sizeof(T) - 1;
+    const V sum = (V)((UV)a + (UV)b);
+    const V ovf = ((a ^ sum) & (b ^ sum)) >> sign;
+    return (sum & ~ovf) | (((a >> sign) ^ fixed_traits<T>::max) & ovf);
+}
+
+template <typename T> inline typename fixed_vecs<T>::V vec_sub_sat(
+    const typename fixed_vecs<T>::V &a, const typename fixed_vecs<T>::V &b
+){
+    typedef typename fixed_vecs<T>::V V;
+    typedef typename fixed_vecs<T>::UV UV;
+    const int sign = 8*sizeof(T) - 1;
+    const V diff = (V)((UV)a - (UV)b);
+    const V ovf = ((a ^ b) & (a ^ diff)) >> sign;
+    return (diff & ~ovf) | (((a >> sign) ^ fixed_traits<T>::max) & ovf);
+}
+
+//! clamp wide lanes to the range of T
+template <typename T> inline typename fixed_vecs<T>::W vec_clamp_fixed(const typename fixed_vecs<T>::W &v)
+{
+    typedef typename fixed_vecs<T>::W W;
+    const W hi = v > fixed_traits<T>::max;
+    const W lo = v < fixed_traits<T>::min;
+    return (v & ~(hi | lo)) | (hi & fixed_traits<T>::max) | (lo & fixed_traits<T>::min);
+}
+
+//! put the low lanes of even and odd back into one vector
+template <typename T> inline typename fixed_vecs<T>::V vec_join_fixed(
+    const typename fixed_vecs<T>::W &even, const typename fixed_vecs<T>::W &odd
+){
+    typedef typename fixed_vecs<T>::UW UW;
+    const int shift = 8*sizeof(T);
+    const UW lo_mask = UW() + ((typename fixed_traits<T>::unsigned_wide_type)(1) << shift) - 1;
+    return (typename fixed_vecs<T>::V)(((UW)even & lo_mask) | ((UW)odd << shift));
+}
+
+template <typename T> inline typename fixed_vecs<T>::V vec_mul_fixed(
+    const typename fixed_vecs<T>::V &a, const typename fixed_vecs<T>::V &b
+){
+    typedef typename fixed_vecs<T>::W W;
+    typedef typename fixed_vecs<T>::UW UW;
+    const int shift = 8*sizeof(T), bits = fixed_traits<T>::bits;
+    const W ae = (W)((UW)a << shift) >> shift, ao = (W)a >> shift;
+    const W be = (W)((UW)b << shift) >> shift, bo = (W)b >> shift;
+    const W even = (ae*be + (1 << (bits-1))) >> bits;
+    const W odd = (ao*bo + (1 << (bits-1))) >> bits;
+    return vec_join_fixed<T>(vec_clamp_fixed<T>(even), vec_clamp_fixed<T>(odd));
+}
+
+//the real part fits the wide lane, the imaginary part can
+//overflow by one for -1-1j squared, so its sum saturates
+template <typename T> inline typename fixed_vecs<T>::V vec_complex_mul_fixed(
+    const typename fixed_vecs<T>::V &a, const typename fixed_vecs<T>::V &b
+){
+    typedef typename fixed_vecs<T>::W W;
+    typedef typename fixed_vecs<T>::UW UW;
+    const int shift = 8*sizeof(T), bits = fixed_traits<T>::bits;
+    const W ar = (W)((UW)a << shift) >> shift, ai = (W)a >> shift;
+    const W br = (W)((UW)b << shift) >> shift, bi = (W)b >> shift;
+    const W re = (ar*br - ai*bi + (1 << (bits-1))) >> bits;
+    const W p1 = ar*bi + (1 << (bits-1)), p2 = ai*br;
+    const W sum = (W)((UW)p1 + (UW)p2);
+    const W ovf = ((p1 ^ sum) & (p2 ^ sum)) >> (2*shift - 1);
+    const W wide_max = (W)((UW() - 1) >> 1);
+    const W im = ((sum & ~ovf) | (wide_max & ovf)) >> bits;
+    return vec_join_fixed<T>(vec_clamp_fixed<T>(re), vec_clamp_fixed<T>(im));
+}
+
+typedef vec_of<int8_t>::type vec_int8;
+typedef vec_of<int16_t>::type vec_int16;
+
+#ifdef EXTRAS_X86_SAT
+#if EXTRAS_X86_SAT == 256
+typedef __m256i sat_si;
+#define EXTRAS_SAT(op) _mm256_ ## op
+#else
+typedef __m128i sat_si;
+#define EXTRAS_SAT(op) _mm_ ## op
+#endif
+
+//! sign extend the low or high half of the bytes in each lane
+inline sat_si sat_widen_lo(const sat_si &x)
+{
+    return EXTRAS_SAT(srai_epi16)(EXTRAS_SAT(unpacklo_epi8)(x, x), 8);
+}
+
+inline sat_si sat_widen_hi(const sat_si &x)
+{
+    return EXTRAS_SAT(srai_epi16)(EXTRAS_SAT(unpackhi_epi8)(x, x), 8);
+}
+
+//complex int16 pairs, returns the products rounded by shift
+//and packed with saturation back into int16 pairs:
+//the imaginary sum only wraps for -1-1j squared, flip it positive,
+//the real part adds ai*~bi + ai so that -bi can not overflow
+inline sat_si sat_complex_mul(const sat_si &x, const sat_si &y, const int shift)
+{
+    const sat_si round = EXTRAS_SAT(set1_epi32)(1 << (shift-1));
+    const sat_si swap = EXTRAS_SAT(shufflehi_epi16)(EXTRAS_SAT(shufflelo_epi16)(y, 0xb1), 0xb1);
+    const sat_si im_sum = EXTRAS_SAT(madd_epi16)(x, swap);
+    const sat_si ovf = EXTRAS_SAT(cmpeq_epi32)(im_sum, EXTRAS_SAT(set1_epi32)(int(0x80000000)));
+    const sat_si im = EXTRAS_SAT(srai_epi32)(EXTRAS_SAT(add_epi32)(im_sum, round), shift) ^ ovf;
+    const sat_si conj = y ^ EXTRAS_SAT(set1_epi32)(int(0xffff0000));
+    const sat_si re_sum = EXTRAS_SAT(add_epi32)(EXTRAS_SAT(madd_epi16)(x, conj), EXTRAS_SAT(srai_epi32)(x, 16));
+    const sat_si re = EXTRAS_SAT(srai_epi32)(EXTRAS_SAT(add_epi32)(re_sum, round), shift);
+    const sat_si packed = EXTRAS_SAT(packs_epi32)(re, im);
+    return EXTRAS_SAT(unpacklo_epi16)(packed, EXTRAS_SAT(unpackhi_epi64)(packed, packed));
+}
+#endif
+
+inline vec_int8 add_sat_of(const vec_int8 &a, const vec_int8 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    return (vec_int8)EXTRAS_SAT(adds_epi8)((sat_si)a, (sat_si)b);
+    #else
+    return vec_add_sat<int8_t>(a, b);
+    #endif
+}
+
+inline vec_int16 add_sat_of(const vec_int16 &a, const vec_int16 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    return (vec_int16)EXTRAS_SAT(adds_epi16)((sat_si)a, (sat_si)b);
+    #else
+    return vec_add_sat<int16_t>(a, b);
+    #endif
+}
+
+inline vec_int8 sub_sat_of(const vec_int8 &a, const vec_int8 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    return (vec_int8)EXTRAS_SAT(subs_epi8)((sat_si)a, (sat_si)b);
+    #else
+    return vec_sub_sat<int8_t>(a, b);
+    #endif
+}
+
+inline vec_int16 sub_sat_of(const vec_int16 &a, const vec_int16 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    return (vec_int16)EXTRAS_SAT(subs_epi16)((sat_si)a, (sat_si)b);
+    #else
+    return vec_sub_sat<int16_t>(a, b);
+    #endif
+}
+
+//widen to int16, the product and rounding can not overflow there,
+//and the saturating pack puts the bytes back in order
+inline vec_int8 mul_fixed_of(const vec_int8 &a, const vec_int8 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    const sat_si x = (sat_si)a, y = (sat_si)b;
+    const sat_si round = EXTRAS_SAT(set1_epi16)(1 << 6);
+    const sat_si lo = EXTRAS_SAT(mullo_epi16)(sat_widen_lo(x), sat_widen_lo(y));
+    const sat_si hi = EXTRAS_SAT(mullo_epi16)(sat_widen_hi(x), sat_widen_hi(y));
+    return (vec_int8)EXTRAS_SAT(packs_epi16)(
+        EXTRAS_SAT(srai_epi16)(EXTRAS_SAT(add_epi16)(lo, round), 7),
+        EXTRAS_SAT(srai_epi16)(EXTRAS_SAT(add_epi16)(hi, round), 7)
+    );
+    #else
+    return vec_mul_fixed<int8_t>(a, b);
+    #endif
+}
+
+//pmulhrsw rounds like Q15 but wraps -1.0 * -1.0 to -1.0,
+//which is the only way it can return -1.0, so flip those lanes;
+//plain sse2 builds the 32 bit products and packs with saturation
+inline vec_int16 mul_fixed_of(const vec_int16 &a, const vec_int16 &b)
+{
+    #if EXTRAS_X86_SAT == 256 || (EXTRAS_X86_SAT == 128 && defined(__SSSE3__))
+    const vec_int16 r = (vec_int16)EXTRAS_SAT(mulhrs_epi16)((sat_si)a, (sat_si)b);
+    return r ^ (r == fixed_traits<int16_t>::min);
+    #elif defined(EXTRAS_X86_SAT)
+    const sat_si x = (sat_si)a, y = (sat_si)b;
+    const sat_si round = EXTRAS_SAT(set1_epi32)(1 << 14);
+    const sat_si lo = EXTRAS_SAT(mullo_epi16)(x, y), hi = EXTRAS_SAT(mulhi_epi16)(x, y);
+    return (vec_int16)EXTRAS_SAT(packs_epi32)(
+        EXTRAS_SAT(srai_epi32)(EXTRAS_SAT(add_epi32)(EXTRAS_SAT(unpacklo_epi16)(lo, hi), round), 15),
+        EXTRAS_SAT(srai_epi32)(EXTRAS_SAT(add_epi32)(EXTRAS_SAT(unpackhi_epi16)(lo, hi), round), 15)
+    );
+    #else
+    return vec_mul_fixed<int16_t>(a, b);
+    #endif
+}
+
+inline vec_int8 complex_mul_fixed_of(const vec_int8 &a, const vec_int8 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    const sat_si x = (sat_si)a, y = (sat_si)b;
+    return (vec_int8)EXTRAS_SAT(packs_epi16)(
+        sat_complex_mul(sat_widen_lo(x), sat_widen_lo(y), 7),
+        sat_complex_mul(sat_widen_hi(x), sat_widen_hi(y), 7)
+    );
+    #else
+    return vec_complex_mul_fixed<int8_t>(a, b);
+    #endif
+}
+
+inline vec_int16 complex_mul_fixed_of(const vec_int16 &a, const vec_int16 &b)
+{
+    #ifdef EXTRAS_X86_SAT
+    return (vec_int16)sat_complex_mul((sat_si)a, (sat_si)b, 15);
+    #else
+    return vec_complex_mul_fixed<int16_t>(a, b);
+    #endif
+}
+#else
+static const bool vec_fixed_enabled = false;
+#endif
+
+struct add_sat_op
+{
+    static const bool vector = vec_fixed_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return add_sat_of(a, b);}
+};
+
+struct sub_sat_op
+{
+    static const bool vector = vec_fixed_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return sub_sat_of(a, b);}
+};
+
+struct neg_sat_op
+{
+    static const bool vector = vec_fixed_enabled;
+    template <typename T> T operator()(const T &a) const {return sub_sat_of(T(), a);}
+};
+
+struct mul_fixed_op
+{
+    static const bool vector = vec_fixed_enabled;
+    template <typename T> T operator()(const T &a, const T &b) const {return mul_fixed_of(a, b);}
+};
+
+//! T is the lane type, complex items are pairs of lanes in the vectors
+template <typename T>
+struct complex_mul_fixed_op
+{
+    static const bool vector = vec_fixed_enabled;
+
+    std::complex<T> operator()(const std::complex<T> &a, const std::complex<T> &b) const
+    {
+        return mul_fixed_of(a, b);
+    }
+
+    #ifdef EXTRAS_HAVE_VEC_COMPLEX
+    typedef typename vec_of<T>::type V;
+    V operator()(const V &a, const V &b) const
+    {
+        return complex_mul_fixed_of(a, b);
+    }
+    #endif
+};
+
+/***********************************************************************
+ * The vector part of each loop, returns where the scalar part starts.
+ * Items are arrays of lanes, complex items are two lanes.
+ **********************************************************************/
+template <bool enabled> struct vec_loops
+{
+    template <typename T, typename Op>
+    static size_t binary(T *, const T *, const T *, const size_t, const Op &){return 0;}
+
+    template <typename T, typename Op>
+    static size_t unary(T *, const T *, const size_t, const Op &){return 0;}
+
+    template <typename T, typename S, typename Op>
+    static size_t nary(S *, const S *const *, const size_t, const size_t, const Op &){return 0;}
+
+    template <typename T, typename Op>
+    static size_t periodic(T *, const T *, const T *, const size_t, const size_t, const Op &){return 0;}
+};
+
+#ifdef EXTRAS_HAVE_VEC
+template <> struct vec_loops<true>
+{
+    template <typename T, typename Op>
+    static size_t binary(T *out, const T *in0, const T *in1, const size_t n, const Op &op)
+    {
+        typedef typename vec_of<typename lane_of<T>::type>::type V;
+        const size_t w = sizeof(V)/sizeof(T);
+        size_t i = 0;
+        for (; i + 2*w <= n; i += 2*w)
+        {
+            const V a0 = vec_load<V>(in0 + i), a1 = vec_load<V>(in0 + i + w);
+            const V b0 = vec_load<V>(in1 + i), b1 = vec_load<V>(in1 + i + w);
+            vec_store(out + i, op(a0, b0));
+            vec_store(out + i + w, op(a1, b1));
+        }
+        return i;
+    }
+
+    template <typename T, typename Op>
+    static size_t unary(T *out, const T *in, const size_t n, const Op &op)
+    {
+        typedef typename vec_of<typename lane_of<T>::type>::type V;
+        const size_t w = sizeof(V)/sizeof(T);
+        size_t i = 0;
+        for (; i + w <= n; i += w)
+        {
+            vec_store(out + i, op(vec_load<V>(in + i)));
+        }
+        return i;
+    }
+
+    //every input is folded into registers, the output is written once
+    template <typename T, typename S, typename Op>
+    static size_t nary(S *out, const S *const *in, const size_t m, const size_t n, const Op &op)
+    {
+        typedef typename vec_of<typename lane_of<T>::type>::type V;
+        const size_t w = sizeof(V)/sizeof(T);
+        size_t i = 0;
+        for (; i + 4*w <= n; i += 4*w)
+        {
+            V acc0 = vec_load<V>(in[0] + i), acc1 = vec_load<V>(in[0] + i + w);
+            V acc2 = vec_load<V>(in[0] + i + 2*w), acc3 = vec_load<V>(in[0] + i + 3*w);
+            for (size_t k = 1; k < m; k++)
+            {
+                const S *in_k = in[k] + i;
+                acc0 = op(acc0, vec_load<V>(in_k));
+                acc1 = op(acc1, vec_load<V>(in_k + w));
+                acc2 = op(acc2, vec_load<V>(in_k + 2*w));
+                acc3 = op(acc3, vec_load<V>(in_k + 3*w));
+            }
+            vec_store(out + i, acc0);
+            vec_store(out + i + w, acc1);
+            vec_store(out + i + 2*w, acc2);
+            vec_store(out + i + 3*w, acc3);
+        }
+        for (; i + w <= n; i += w)
+        {
+            V acc = vec_load<V>(in[0] + i);
+            for (size_t k = 1; k < m; k++) acc = op(acc, vec_load<V>(in[k] + i));
+            vec_store(out + i, acc);
+        }
+        return i;
+    }
+
+    //the period is a compile time number of vectors, kept in registers
+    template <size_t K, typename T, typename Op>
+    static size_t periodic_regs(T *out, const T *in, const T *pattern, const size_t n, const Op &op)
+    {
+        typedef typename vec_of<typename lane_of<T>::type>::type V;
+        const size_t w = sizeof(V)/sizeof(T);
+        V p[K];
+        for (size_t k = 0; k < K; k++) p[k] = vec_load<V>(pattern + k*w);
+        size_t i = 0;
+        for (; i + K*w <= n; i += K*w)
+        {
+            for (size_t k = 0; k < K; k++)
+            {
+                vec_store(out + i + k*w, op(vec_load<V>(in + i + k*w), p[k]));
+            }
+        }
+        return i;
+    }
+
+    //returns 0 when whole periods do not fill 1, 2, 4 or 8 vectors
+    template <typename T, typename Op>
+    static size_t periodic(T *out, const T *in, const T *pattern, const size_t period, const size_t n, const Op &op)
+    {
+        typedef typename vec_of<typename lane_of<T>::type>::type V;
+        const size_t w = sizeof(V)/sizeof(T);
+        if (w % period == 0) return periodic_regs<1>(out, in, pattern, n, op);
+        if ((2*w) % period == 0) return periodic_regs<2>(out, in, pattern, n, op);
+        if ((4*w) % period == 0) return periodic_regs<4>(out, in, pattern, n, op);
+        if ((8*w) % period == 0) return periodic_regs<8>(out, in, pattern, n, op);
+        return 0;
+    }
+};
+#endif
+
+template <typename T, typename Op>
+inline void binary_loop(T *out, const T *in0, const T *in1, const size_t n, const Op &op)
+{
+    size_t i = vec_loops<Op::vector>::binary(out, in0, in1, n, op);
+    for (; i < n; i++) out[i] = op(in0[i], in1[i]);
+}
+
+template <typename T, typename Op>
+inline void unary_loop(T *out, const T *in, const size_t n, const Op &op)
+{
+    size_t i = vec_loops<Op::vector>::unary(out, in, n, op);
+    for (; i < n; i++) out[i] = op(in[i]);
+}
+
+//! S is the item type in memory, T is the type the op works on
+template <typename T, typename S, typename Op>
+inline void nary_loop(S *out, const S *const *in, const size_t m, const size_t n, const Op &op)
+{
+    size_t i = vec_loops<Op::vector>::template nary<T>(out, in, m, n, op);
+    for (; i < n; i++)
+    {
+        T acc = *reinterpret_cast<const T *>(in[0] + i);
+        for (size_t k = 1; k < m; k++)
+        {
+            acc = op(acc, *reinterpret_cast<const T *>(in[k] + i));
+        }
+        *reinterpret_cast<T *>(out + i) = acc;
+    }
+}
+
+/***********************************************************************
+ * Conversions between the integer types and float, with a scale.
+ * Integer outputs are rounded to nearest even and clamped to the type,
+ * clamping first so out of range and NaN inputs can not wrap.
+ * The int32 top is not a float, so int32 clamps only the low end
+ * and saturates inputs at or past 2^31 after the conversion.
+ * x86 widens and narrows with the sign extend and saturating pack
+ * instructions, and the float multiply folds in the scale.
+ **********************************************************************/
+template <typename T> struct float_range;
+
+template <> struct float_range<int8_t>
+{
+    static float lo(void){return -128.0f;}
+    static float hi(void){return 127.0f;}
+};
+
+template <> struct float_range<int16_t>
+{
+    static float lo(void){return -32768.0f;}
+    static float hi(void){return 32767.0f;}
+};
+
+template <> struct float_range<int32_t>
+{
+    static float lo(void){return -2147483648.0f;}
+    static float hi(void){return 2147483648.0f;} //2^31, the first float past the top
+};
+
+inline float round_nearest(const float x)
+{
+    #ifdef __GNUC__
+    return __builtin_rintf(x);
+    #else
+    return std::floor(x + 0.5f);
+    #endif
+}
+
+template <typename In>
+struct to_float_op
+{
+    to_float_op(const float scale): scale(scale){}
+    float operator()(const In x) const {return float(x)*scale;}
+    const float scale;
+};
+
+template <typename Out>
+struct from_float_op
+{
+    from_float_op(const float scale): scale(scale){}
+    Out operator()(const float x) const
+    {
+        float y = x*scale;
+        y = (y >= float_range<Out>::lo())? y : float_range<Out>::lo();
+        y = (y <= float_range<Out>::hi())? y : float_range<Out>::hi();
+        return Out(round_nearest(y));
+    }
+    const float scale;
+};
+
+template <>
+struct from_float_op<int32_t>
+{
+    from_float_op(const float scale): scale(scale){}
+    int32_t operator()(const float x) const
+    {
+        float y = x*scale;
+        if (y >= float_range<int32_t>::hi()) return 2147483647;
+        y = (y >= float_range<int32_t>::lo())? y : float_range<int32_t>::lo();
+        return int32_t(round_nearest(y));
+    }
+    const float scale;
+};
+
+//! The vector part of a conversion, returns where the scalar part starts
+template <typename Out, typename In, typename Op>
+inline size_t vec_convert(Out *, const In *, const size_t, const Op &){return 0;}
+
+#ifdef EXTRAS_X86_SAT
+#if EXTRAS_X86_SAT == 256
+typedef __m256 sat_ps;
+#else
+typedef __m128 sat_ps;
+#endif
+
+//sign extend the low or high half of the lanes, keeping the order,
+//avx2 unpacks within each 128 bit half so it converts the halves
+inline sat_si widen16_lo(const sat_si &x)
+{
+    #if EXTRAS_X86_SAT == 256
+    return _mm256_cvtepi16_epi32(_mm256_castsi256_si128(x));
+    #else
+    return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    #endif
+}
+
+inline sat_si widen16_hi(const sat_si &x)
+{
+    #if EXTRAS_X86_SAT == 256
+    return _mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1));
+    #else
+    return _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+    #endif
+}
+
+inline sat_si widen8_lo(const sat_si &x)
+{
+    #if EXTRAS_X86_SAT == 256
+    return _mm256_cvtepi8_epi16(_mm256_castsi256_si128(x));
+    #else
+    return sat_widen_lo(x);
+    #endif
+}
+
+inline sat_si widen8_hi(const sat_si &x)
+{
+    #if EXTRAS_X86_SAT == 256
+    return _mm256_cvtepi8_epi16(_mm256_extracti128_si256(x, 1));
+    #else
+    return sat_widen_hi(x);
+    #endif
+}
+
+//the saturating packs, avx2 packs within each 128 bit half,
+//so the 64 bit quarters are put back in order afterwards
+inline sat_si narrow32(const sat_si &a, const sat_si &b)
+{
+    #if EXTRAS_X86_SAT == 256
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+    #else
+    return _mm_packs_epi32(a, b);
+    #endif
+}
+
+inline sat_si narrow16(const sat_si &a, const sat_si &b)
+{
+    #if EXTRAS_X86_SAT == 256
+    return _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xd8);
+    #else
+    return _mm_packs_epi16(a, b);
+    #endif
+}
+
+inline sat_ps to_ps(const sat_si &x, const sat_ps &scale)
+{
+    return EXTRAS_SAT(mul_ps)(EXTRAS_SAT(cvtepi32_ps)(x), scale);
+}
+
+//max and min return the bound for NaN, like the scalar op
+inline sat_si from_ps(const float *in, const sat_ps &scale, const sat_ps &lo, const sat_ps &hi)
+{
+    const sat_ps x = EXTRAS_SAT(mul_ps)(vec_load<sat_ps>(in), scale);
+    return EXTRAS_SAT(cvtps_epi32)(EXTRAS_SAT(min_ps)(EXTRAS_SAT(max_ps)(x, lo), hi));
+}
+
+//cvtps gives 0x80000000 at or past 2^31, flip those lanes to 0x7fffffff
+inline sat_si from_ps32(const float *in, const sat_ps &scale, const sat_ps &lo, const sat_ps &top)
+{
+    const sat_ps x = EXTRAS_SAT(max_ps)(EXTRAS_SAT(mul_ps)(vec_load<sat_ps>(in), scale), lo);
+    #if EXTRAS_X86_SAT == 256
+    const sat_si over = _mm256_castps_si256(_mm256_cmp_ps(x, top, _CMP_GE_OQ));
+    #else
+    const sat_si over = _mm_castps_si128(_mm_cmpge_ps(x, top));
+    #endif
+    return EXTRAS_SAT(cvtps_epi32)(x) ^ over;
+}
+
+inline size_t vec_convert(float *out, const int32_t *in, const size_t n, const to_float_op<int32_t> &op)
+{
+    const sat_ps scale = EXTRAS_SAT(set1_ps)(op.scale);
+    const size_t w = sizeof(sat_si)/sizeof(int32_t);
+    size_t i = 0;
+    for (; i + w <= n; i += w)
+    {
+        vec_store(out + i, to_ps(vec_load<sat_si>(in + i), scale));
+    }
+    return i;
+}
+
+inline size_t vec_convert(float *out, const int16_t *in, const size_t n, const to_float_op<int16_t> &op)
+{
+    const sat_ps scale = EXTRAS_SAT(set1_ps)(op.scale);
+    const size_t w = sizeof(sat_si)/sizeof(int16_t), h = w/2;
+    size_t i = 0;
+    for (; i + w <= n; i += w)
+    {
+        const sat_si x = vec_load<sat_si>(in + i);
+        vec_store(out + i, to_ps(widen16_lo(x), scale));
+        vec_store(out + i + h, to_ps(widen16_hi(x), scale));
+    }
+    return i;
+}
+
+inline size_t vec_convert(float *out, const int8_t *in, const size_t n, const to_float_op<int8_t> &op)
+{
+    const sat_ps scale = EXTRAS_SAT(set1_ps)(op.scale);
+    const size_t w = sizeof(sat_si)/sizeof(int8_t), q = w/4;
+    size_t i = 0;
+    for (; i + w <= n; i += w)
+    {
+        const sat_si x = vec_load<sat_si>(in + i);
+        const sat_si lo = widen8_lo(x), hi = widen8_hi(x);
+        vec_store(out + i, to_ps(widen16_lo(lo), scale));
+        vec_store(out + i + q, to_ps(widen16_hi(lo), scale));
+        vec_store(out + i + 2*q, to_ps(widen16_lo(hi), scale));
+        vec_store(out + i + 3*q, to_ps(widen16_hi(hi), scale));
+    }
+    return i;
+}
+
+inline size_t vec_convert(int32_t *out, const float *in, const size_t n, const from_float_op<int32_t> &op)
+{
+    const sat_ps scale = EXTRAS_SAT(set1_ps)(op.scale);
+    const sat_ps lo = EXTRAS_SAT(set1_ps)(float_range<int32_t>::lo());
+    const sat_ps top = EXTRAS_SAT(set1_ps)(float_range<int32_t>::hi());
+    const size_t w = sizeof(sat_ps)/sizeof(float);
+    size_t i = 0;
+    for (; i + w <= n; i += w)
+    {
+        vec_store(out + i, from_ps32(in + i, scale, lo, top));
+    }
+    return i;
+}
+
+inline size_t vec_convert(int16_t *out, const float *in, const size_t n, const from_float_op<int16_t> &op)
+{
+    const sat_ps scale = EXTRAS_SAT(set1_ps)(op.scale);
+    const sat_ps lo = EXTRAS_SAT(set1_ps)(float_range<int16_t>::lo());
+    const sat_ps hi = EXTRAS_SAT(set1_ps)(float_range<int16_t>::hi());
+    const size_t w = sizeof(sat_ps)/sizeof(float);
+    size_t i = 0;
+    for (; i + 2*w <= n; i += 2*w)
+    {
+        vec_store(out + i, narrow32(
+            from_ps(in + i, scale, lo, hi),
+            from_ps(in + i + w, scale, lo, hi)
+        ));
+    }
+    return i;
+}
+
+inline size_t vec_convert(int8_t *out, const float *in, const size_t n, const from_float_op<int8_t> &op)
+{
+    const sat_ps scale = EXTRAS_SAT(set1_ps)(op.scale);
+    const sat_ps lo = EXTRAS_SAT(set1_ps)(float_range<int8_t>::lo());
+    const sat_ps hi = EXTRAS_SAT(set1_ps)(float_range<int8_t>::hi());
+    const size_t w = sizeof(sat_ps)/sizeof(float);
+    size_t i = 0;
+    for (; i + 4*w <= n; i += 4*w)
+    {
+        vec_store(out + i, narrow16(
+            narrow32(from_ps(in + i, scale, lo, hi), from_ps(in + i + w, scale, lo, hi)),
+            narrow32(from_ps(in + i + 2*w, scale, lo, hi), from_ps(in + i + 3*w, scale, lo, hi))
+        ));
+    }
+    return i;
+}
+#endif
+
+template <typename Out, typename In, typename Op>
+inline void convert_loop(Out *out, const In *in, const size_t n, const Op &op)
+{
+    size_t i = vec_convert(out, in, n, op);
+    for (; i < n; i++) out[i] = op(in[i]);
+}
+
+//! the pattern holds pattern_length(period) items, see op_kernels.h
+template <typename T, typename Op>
+inline void periodic_loop(T *out, const T *in, const T *pattern, const size_t period, const size_t n, const Op &op)
+{
+    //the register loop stops on a whole period, so the rest starts the pattern over
+    const size_t i = vec_loops<Op::vector>::periodic(out, in, pattern, period, n, op);
+    if (i == n) return;
+    const size_t p = gnuradio::kernels::pattern_length(period);
+    for (size_t j = i; j < n; j += p)
+    {
+        binary_loop(out + j, in + j, pattern, std::min(p, n - j), op);
+    }
+}
+
+/***********************************************************************
+ * The table entries, signed types map onto the unsigned loops
+ **********************************************************************/
+#define EXTRAS_BINARY_KERNEL(name, type, utype, op) \
+    void name(type *out, const type *in0, const type *in1, const size_t n){ \
+        binary_loop(reinterpret_cast<utype *>(out), reinterpret_cast<const utype *>(in0), \
+            reinterpret_cast<const utype *>(in1), n, op()); \
+    }
+
+#define EXTRAS_UNARY_KERNEL(name, type, utype, op) \
+    void name(type *out, const type *in, const size_t n){ \
+        unary_loop(reinterpret_cast<utype *>(out), reinterpret_cast<const utype *>(in), n, op()); \
+    }
+
+#define EXTRAS_NARY_KERNEL(name, type, utype, op) \
+    void name(type *out, const type *const *in, const size_t m, const size_t n){ \
+        nary_loop<utype>(out, in, m, n, op()); \
+    }
+
+EXTRAS_BINARY_KERNEL(add8, int8_t, uint8_t, add_op)
+EXTRAS_BINARY_KERNEL(add16, int16_t, uint16_t, add_op)
+EXTRAS_BINARY_KERNEL(add32, int32_t, uint32_t, add_op)
+EXTRAS_BINARY_KERNEL(addf, float, float, add_op)
+EXTRAS_BINARY_KERNEL(sub8, int8_t, uint8_t, sub_op)
+EXTRAS_BINARY_KERNEL(sub16, int16_t, uint16_t, sub_op)
+EXTRAS_BINARY_KERNEL(sub32, int32_t, uint32_t, sub_op)
+EXTRAS_BINARY_KERNEL(subf, float, float, sub_op)
+EXTRAS_UNARY_KERNEL(neg8, int8_t, uint8_t, neg_op)
+EXTRAS_UNARY_KERNEL(neg16, int16_t, uint16_t, neg_op)
+EXTRAS_UNARY_KERNEL(neg32, int32_t, uint32_t, neg_op)
+EXTRAS_UNARY_KERNEL(negf, float, float, neg_op)
+EXTRAS_BINARY_KERNEL(mul8, int8_t, uint8_t, mul_op)
+EXTRAS_BINARY_KERNEL(mul16, int16_t, uint16_t, mul_op)
+EXTRAS_BINARY_KERNEL(mul32, int32_t, uint32_t, mul_op)
+EXTRAS_BINARY_KERNEL(mulf, float, float, mul_op)
+
+typedef complex_mul_op<uint8_t, uint16_t> complex_mul8_op;
+typedef complex_mul_op<uint16_t, uint32_t> complex_mul16_op;
+typedef complex_mul_op<uint32_t, uint64_t> complex_mul32_op;
+typedef complex_mul_op<float, uint64_t> complex_mulf_op;
+
+EXTRAS_BINARY_KERNEL(mulc8, std::complex<int8_t>, std::complex<uint8_t>, complex_mul8_op)
+EXTRAS_BINARY_KERNEL(mulc16, std::complex<int16_t>, std::complex<uint16_t>, complex_mul16_op)
+EXTRAS_BINARY_KERNEL(mulc32, std::complex<int32_t>, std::complex<uint32_t>, complex_mul32_op)
+EXTRAS_BINARY_KERNEL(mulcf, std::complex<float>, std::complex<float>, complex_mulf_op)
+
+EXTRAS_NARY_KERNEL(addn8, int8_t, uint8_t, add_op)
+EXTRAS_NARY_KERNEL(addn16, int16_t, uint16_t, add_op)
+EXTRAS_NARY_KERNEL(addn32, int32_t, uint32_t, add_op)
+EXTRAS_NARY_KERNEL(addnf, float, float, add_op)
+EXTRAS_NARY_KERNEL(subn8, int8_t, uint8_t, sub_op)
+EXTRAS_NARY_KERNEL(subn16, int16_t, uint16_t, sub_op)
+EXTRAS_NARY_KERNEL(subn32, int32_t, uint32_t, sub_op)
+EXTRAS_NARY_KERNEL(subnf, float, float, sub_op)
+EXTRAS_NARY_KERNEL(muln8, int8_t, uint8_t, mul_op)
+EXTRAS_NARY_KERNEL(muln16, int16_t, uint16_t, mul_op)
+EXTRAS_NARY_KERNEL(muln32, int32_t, uint32_t, mul_op)
+EXTRAS_NARY_KERNEL(mulnf, float, float, mul_op)
+EXTRAS_NARY_KERNEL(mulnc8, std::complex<int8_t>, std::complex<uint8_t>, complex_mul8_op)
+EXTRAS_NARY_KERNEL(mulnc16, std::complex<int16_t>, std::complex<uint16_t>, complex_mul16_op)
+EXTRAS_NARY_KERNEL(mulnc32, std::complex<int32_t>, std::complex<uint32_t>, complex_mul32_op)
+EXTRAS_NARY_KERNEL(mulncf, std::complex<float>, std::complex<float>, complex_mulf_op)
+EXTRAS_NARY_KERNEL(divn8, int8_t, int8_t, div_op)
+EXTRAS_NARY_KERNEL(divn16, int16_t, int16_t, div_op)
+EXTRAS_NARY_KERNEL(divn32, int32_t, int32_t, div_op)
+EXTRAS_NARY_KERNEL(divnf, float, float, div_op)
+
+typedef complex_int_div_op<int8_t, int32_t> complex_div8_op;
+typedef complex_int_div_op<int16_t, int32_t> complex_div16_op;
+typedef complex_int_div_op<int32_t, int64_t> complex_div32_op;
+typedef complex_float_div_op<div_op> complex_divf_op;
+
+EXTRAS_NARY_KERNEL(divnc8, std::complex<int8_t>, std::complex<int8_t>, complex_div8_op)
+EXTRAS_NARY_KERNEL(divnc16, std::complex<int16_t>, std::complex<int16_t>, complex_div16_op)
+EXTRAS_NARY_KERNEL(divnc32, std::complex<int32_t>, std::complex<int32_t>, complex_div32_op)
+EXTRAS_NARY_KERNEL(divncf, std::complex<float>, std::complex<float>, complex_divf_op)
+EXTRAS_UNARY_KERNEL(rcp8, int8_t, int8_t, rcp_op<div_op>)
+EXTRAS_UNARY_KERNEL(rcp16, int16_t, int16_t, rcp_op<div_op>)
+EXTRAS_UNARY_KERNEL(rcp32, int32_t, int32_t, rcp_op<div_op>)
+EXTRAS_UNARY_KERNEL(rcpf, float, float, rcp_op<div_op>)
+EXTRAS_UNARY_KERNEL(rcpc8, std::complex<int8_t>, std::complex<int8_t>, rcp_op<complex_div8_op>)
+EXTRAS_UNARY_KERNEL(rcpc16, std::complex<int16_t>, std::complex<int16_t>, rcp_op<complex_div16_op>)
+EXTRAS_UNARY_KERNEL(rcpc32, std::complex<int32_t>, std::complex<int32_t>, rcp_op<complex_div32_op>)
+EXTRAS_UNARY_KERNEL(rcpcf, std::complex<float>, std::complex<float>, rcp_op<complex_divf_op>)
+EXTRAS_NARY_KERNEL(divnf_fast, float, float, div_fast_op)
+EXTRAS_UNARY_KERNEL(rcpf_fast, float, float, rcp_op<div_fast_op>)
+
+EXTRAS_BINARY_KERNEL(addsat8, int8_t, int8_t, add_sat_op)
+EXTRAS_BINARY_KERNEL(addsat16, int16_t, int16_t, add_sat_op)
+EXTRAS_BINARY_KERNEL(subsat8, int8_t, int8_t, sub_sat_op)
+EXTRAS_BINARY_KERNEL(subsat16, int16_t, int16_t, sub_sat_op)
+EXTRAS_UNARY_KERNEL(negsat8, int8_t, int8_t, neg_sat_op)
+EXTRAS_UNARY_KERNEL(negsat16, int16_t, int16_t, neg_sat_op)
+EXTRAS_BINARY_KERNEL(mulq7, int8_t, int8_t, mul_fixed_op)
+EXTRAS_BINARY_KERNEL(mulq15, int16_t, int16_t, mul_fixed_op)
+EXTRAS_BINARY_KERNEL(mulcq7, std::complex<int8_t>, std::complex<int8_t>, complex_mul_fixed_op<int8_t>)
+EXTRAS_BINARY_KERNEL(mulcq15, std::complex<int16_t>, std::complex<int16_t>, complex_mul_fixed_op<int16_t>)
+EXTRAS_NARY_KERNEL(addnsat8, int8_t, int8_t, add_sat_op)
+EXTRAS_NARY_KERNEL(addnsat16, int16_t, int16_t, add_sat_op)
+EXTRAS_NARY_KERNEL(subnsat8, int8_t, int8_t, sub_sat_op)
+EXTRAS_NARY_KERNEL(subnsat16, int16_t, int16_t, sub_sat_op)
+EXTRAS_NARY_KERNEL(mulnq7, int8_t, int8_t, mul_fixed_op)
+EXTRAS_NARY_KERNEL(mulnq15, int16_t, int16_t, mul_fixed_op)
+EXTRAS_NARY_KERNEL(mulncq7, std::complex<int8_t>, std::complex<int8_t>, complex_mul_fixed_op<int8_t>)
+EXTRAS_NARY_KERNEL(mulncq15, std::complex<int16_t>, std::complex<int16_t>, complex_mul_fixed_op<int16_t>)
+
+#define EXTRAS_CONVERT_KERNEL(name, out_type, in_type, op) \
+    void name(out_type *out, const in_type *in, const float scale, const size_t n){ \
+        convert_loop(out, in, n, op(scale)); \
+    }
+
+EXTRAS_CONVERT_KERNEL(cvt8f, float, int8_t, to_float_op<int8_t>)
+EXTRAS_CONVERT_KERNEL(cvt16f, float, int16_t, to_float_op<int16_t>)
+EXTRAS_CONVERT_KERNEL(cvt32f, float, int32_t, to_float_op<int32_t>)
+EXTRAS_CONVERT_KERNEL(cvtf8, int8_t, float, from_float_op<int8_t>)
+EXTRAS_CONVERT_KERNEL(cvtf16, int16_t, float, from_float_op<int16_t>)
+EXTRAS_CONVERT_KERNEL(cvtf32, int32_t, float, from_float_op<int32_t>)
+
+#define EXTRAS_PERIODIC_KERNEL(name, type, utype, op) \
+    void name(type *out, const type *in, const type *pattern, const size_t period, const size_t n){ \
+        periodic_loop(reinterpret_cast<utype *>(out), reinterpret_cast<const utype *>(in), \
+            reinterpret_cast<const utype *>(pattern), period, n, op()); \
+    }
+
+EXTRAS_PERIODIC_KERNEL(addp8, int8_t, uint8_t, add_op)
+EXTRAS_PERIODIC_KERNEL(addp16, int16_t, uint16_t, add_op)
+EXTRAS_PERIODIC_KERNEL(addp32, int32_t, uint32_t, add_op)
+EXTRAS_PERIODIC_KERNEL(addpf, float, float, add_op)
+EXTRAS_PERIODIC_KERNEL(mulp8, int8_t, uint8_t, mul_op)
+EXTRAS_PERIODIC_KERNEL(mulp16, int16_t, uint16_t, mul_op)
+EXTRAS_PERIODIC_KERNEL(mulp32, int32_t, uint32_t, mul_op)
+EXTRAS_PERIODIC_KERNEL(mulpf, float, float, mul_op)
+EXTRAS_PERIODIC_KERNEL(mulpc8, std::complex<int8_t>, std::complex<uint8_t>, complex_mul8_op)
+EXTRAS_PERIODIC_KERNEL(mulpc16, std::complex<int16_t>, std::complex<uint16_t>, complex_mul16_op)
+EXTRAS_PERIODIC_KERNEL(mulpc32, std::complex<int32_t>, std::complex<uint32_t>, complex_mul32_op)
+EXTRAS_PERIODIC_KERNEL(mulpcf, std::complex<float>, std::complex<float>, complex_mulf_op)
+EXTRAS_PERIODIC_KERNEL(addpsat8, int8_t, int8_t, add_sat_op)
+EXTRAS_PERIODIC_KERNEL(addpsat16, int16_t, int16_t, add_sat_op)
+EXTRAS_PERIODIC_KERNEL(mulpq7, int8_t, int8_t, mul_fixed_op)
+EXTRAS_PERIODIC_KERNEL(mulpq15, int16_t, int16_t, mul_fixed_op)
+EXTRAS_PERIODIC_KERNEL(mulpcq7, std::complex<int8_t>, std::complex<int8_t>, complex_mul_fixed_op<int8_t>)
+EXTRAS_PERIODIC_KERNEL(mulpcq15, std::complex<int16_t>, std::complex<int16_t>, complex_mul_fixed_op<int16_t>)
+
+//! Make the table of the kernels in this translation unit
+inline gnuradio::kernels::kernel_table make_kernel_table(const char *name)
+{
+    gnuradio::kernels::kernel_table t = {
+        name,
+        add8, add16, add32, addf,
+        sub8, sub16, sub32, subf,
+        neg8, neg16, neg32, negf,
+        mul8, mul16, mul32, mulf,
+        mulc8, mulc16, mulc32, mulcf,
+        addn8, addn16, addn32, addnf,
+        subn8, subn16, subn32, subnf,
+        muln8, muln16, muln32, mulnf,
+        mulnc8, mulnc16, mulnc32, mulncf,
+        divn8, divn16, divn32, divnf,
+        divnc8, divnc16, divnc32, divncf,
+        rcp8, rcp16, rcp32, rcpf,
+        rcpc8, rcpc16, rcpc32, rcpcf,
+        divnf_fast, rcpf_fast,
+        addsat8, addsat16, subsat8, subsat16, negsat8, negsat16,
+        mulq7, mulq15, mulcq7, mulcq15,
+        addnsat8, addnsat16, subnsat8, subnsat16,
+        mulnq7, mulnq15, mulncq7, mulncq15,
+        cvt8f, cvt16f, cvt32f, cvtf8, cvtf16, cvtf32,
+        addp8, addp16, addp32, addpf, mulp8, mulp16, mulp32, mulpf,
+        mulpc8, mulpc16, mulpc32, mulpcf,
+        addpsat8, addpsat16, mulpq7, mulpq15, mulpcq7, mulpcq15
+    };
+    return t;
+}
+
+} //namespace
+
+#endif /* INCLUDED_GR_EXTRAS_OP_KERNELS_SIMD_H */
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_PARAM_HOLDER_H
+#define INCLUDED_GR_EXTRAS_PARAM_HOLDER_H
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace gnuradio{
+
+/*!
+ * A parameter that control threads set while work() reads it.
+ *
+ * Setters publish a complete new snapshot with an atomic pointer swap.
+ * The work thread picks up the latest snapshot at the top of work()
+ * and keeps using it for the whole call, so it never sees a half update.
+ * When nothing changed, the cost to work() is one relaxed load.
+ *
+ * The old snapshot is handed back to the setters to be reused,
+ * so a steady stream of updates does not allocate.
+ * Any thread may call set(), only the work thread may call get().
+ * A single scalar setting does not need a snapshot, use a boost::atomic.
+ */
+template <typename T>
+class param_holder : boost::noncopyable
+{
+public:
+    param_holder(const T &init = T()):
+        _current(new T(init)), _pending(NULL), _spare(NULL)
+    {
+        //NOP
+    }
+
+    ~param_holder(void)
+    {
+        delete _current;
+        delete _pending.load();
+        delete _spare.load();
+    }
+
+    //! Publish a new value, safe to call from any thread
+    void set(const T &val)
+    {
+        T *snap = _spare.exchange(NULL, boost::memory_order_acquire);
+        if (snap == NULL) snap = new T(val);
+        else *snap = val;
+
+        //an update that work() never picked up is recycled
+        T *stale = _pending.exchange(snap, boost::memory_order_acq_rel);
+        if (stale != NULL) this->recycle(stale);
+    }
+
+    //! Take the latest published value, true if it changed (work thread only)
+    bool update(void)
+    {
+        if (_pending.load(boost::memory_order_relaxed) == NULL) return false;
+        T *fresh = _pending.exchange(NULL, boost::memory_order_acquire);
+        if (fresh == NULL) return false;
+        this->recycle(_current);
+        _current = fresh;
+        return true;
+    }
+
+    //! The value that work() is using (work thread only)
+    const T &value(void) const
+    {
+        return *_current;
+    }
+
+    //! Update and return the value, call once at the top of work()
+    const T &get(void)
+    {
+        this->update();
+        return this->value();
+    }
+
+private:
+    void recycle(T *old)
+    {
+        delete _spare.exchange(old, boost::memory_order_acq_rel);
+    }
+
+    T *_current;
+    boost::atomic<T *> _pending;
+    boost::atomic<T *> _spare;
+};
+
+} //namespace gnuradio
+
+#endif /* INCLUDED_GR_EXTRAS_PARAM_HOLDER_H */
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_PERF_TICKS_H
+#define INCLUDED_GR_EXTRAS_PERF_TICKS_H
+
+//! High resolution monotonic ticks for the performance counters and tracer
+#ifdef _WIN32
+#include <windows.h>
+
+static inline long long perf_ticks(void)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static inline double perf_ticks_per_sec(void)
+{
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    return double(freq.QuadPart);
+}
+
+#else
+#include <time.h>
+
+static inline long long perf_ticks(void)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec*1000000000LL + now.tv_nsec;
+}
+
+static inline double perf_ticks_per_sec(void)
+{
+    return 1e9;
+}
+
+#endif
+
+#endif /* INCLUDED_GR_EXTRAS_PERF_TICKS_H */
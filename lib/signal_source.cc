@@ -21,6 +21,9 @@
 
 #include <gnuradio/extras/signal_source.h>
 #include <gr_io_signature.h>
+#include <gruel/thread.h>
+#include <boost/atomic.hpp>
+#include "param_holder.h"
 #include <stdexcept>
 #include <complex>
 #include <cmath>
@@ -46,10 +49,11 @@ public:
             gr_make_io_signature (0, 0, 0),
             gr_make_io_signature (1, 1, sizeof(type))
         ),
-        _index(0), _step(0),
-        _table(wave_table_size),
+        _index(0),
+        _step(0), _table(std::vector<type>(wave_table_size)),
+        _new_table(wave_table_size),
         _offset(0.0), _scalar(1.0),
-        _wave("CONST")
+        _wave("CONST"), _step_setting(0)
     {
         this->update_table();
     }
@@ -58,91 +62,111 @@ public:
         const InputItems &input_items,
         const OutputItems &output_items
     ){
+        const size_t step = _step.load(boost::memory_order_relaxed);
+        const std::vector<type> &table = _table.get();
         type *out = output_items[0].cast<type *>();
         for (size_t i = 0; i < output_items[0].size(); i++){
-            out[i] = _table[_index % wave_table_size];
-            _index += _step;
+            out[i] = table[_index % wave_table_size];
+            _index += step;
         }
         return output_items[0].size();
     }
 
     void set_waveform(const std::string &wave){
+        gruel::scoped_lock l(_setter_mutex);
         _wave = wave;
         this->update_table();
     }
 
     std::string get_waveform(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _wave;
     }
 
     void set_offset(const std::complex<double> &offset){
+        gruel::scoped_lock l(_setter_mutex);
         _offset = offset;
         this->update_table();
     }
 
     std::complex<double> get_offset(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _offset;
     }
 
     void set_amplitude(const std::complex<double> &scalar){
+        gruel::scoped_lock l(_setter_mutex);
         _scalar = scalar;
         this->update_table();
     }
 
     std::complex<double> get_amplitude(void){
+        gruel::scoped_lock l(_setter_mutex);
         return _scalar;
     }
 
     void set_frequency(const double freq){
-        _step = boost::math::iround(freq*_table.size());
+        gruel::scoped_lock l(_setter_mutex);
+        _step_setting = boost::math::iround(freq*wave_table_size);
+        _step.store(_step_setting, boost::memory_order_relaxed);
     }
 
     double get_frequency(void){
-        return double(_step)/_table.size();
+        gruel::scoped_lock l(_setter_mutex);
+        return double(_step_setting)/wave_table_size;
     }
 
+    //! build the table from the settings and publish it, setter mutex held
     void update_table(void){
+        const size_t size = _new_table.size();
         if (_wave == "CONST"){
-            for (size_t i = 0; i < _table.size(); i++){
+            for (size_t i = 0; i < size; i++){
                 this->set_elem(i, 1.0);
             }
         }
         else if (_wave == "COSINE"){
-            for (size_t i = 0; i < _table.size(); i++){
-                this->set_elem(i, std::pow(M_E, std::complex<double>(0, M_PI*2*i/_table.size())));
+            for (size_t i = 0; i < size; i++){
+                this->set_elem(i, std::pow(M_E, std::complex<double>(0, M_PI*2*i/size)));
             }
         }
         else if (_wave == "RAMP"){
-            for (size_t i = 0; i < _table.size(); i++){
-                const size_t q = (i+(3*_table.size())/4)%_table.size();
+            for (size_t i = 0; i < size; i++){
+                const size_t q = (i+(3*size)/4)%size;
                 this->set_elem(i, std::complex<double>(
-                    2.0*i/(_table.size()-1) - 1.0,
-                    2.0*q/(_table.size()-1) - 1.0
+                    2.0*i/(size-1) - 1.0,
+                    2.0*q/(size-1) - 1.0
                 ));
             }
         }
         else if (_wave == "SQUARE"){
-            for (size_t i = 0; i < _table.size(); i++){
-                const size_t q = (i+(3*_table.size())/4)%_table.size();
+            for (size_t i = 0; i < size; i++){
+                const size_t q = (i+(3*size)/4)%size;
                 this->set_elem(i, std::complex<double>(
-                    (i < _table.size()/2)? 0.0 : 1.0,
-                    (q < _table.size()/2)? 0.0 : 1.0
+                    (i < size/2)? 0.0 : 1.0,
+                    (q < size/2)? 0.0 : 1.0
                 ));
             }
         }
         else throw std::invalid_argument("sig source got unknown wave type: " + _wave);
+        _table.set(_new_table);
     }
 
     inline void set_elem(const size_t index, const std::complex<double> &val){
-        gr_complex_double_to_num(_scalar * val + _offset, _table[index]);
+        gr_complex_double_to_num(_scalar * val + _offset, _new_table[index]);
     }
 
 private:
+    //work thread state
     size_t _index;
-    size_t _step;
-    std::vector<type> _table;
+    boost::atomic<size_t> _step;
+    gnuradio::param_holder<std::vector<type> > _table;
+
+    //setter state
+    gruel::mutex _setter_mutex;
+    std::vector<type> _new_table;
     std::complex<double> _offset, _scalar;
     std::string _wave;
+    size_t _step_setting;
 };
 
 /***********************************************************************
@@ -26,7 +26,9 @@
 #include <boost/thread/thread.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/weak_ptr.hpp>
+#include <boost/atomic.hpp>
 #include <iostream>
+#include "thread_sched.h"
 
 namespace asio = boost::asio;
 
@@ -189,6 +191,7 @@ public:
         asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), addr, port);
         asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
         _acceptor = boost::shared_ptr<asio::ip::tcp::acceptor>(new asio::ip::tcp::acceptor(*_io_service, endpoint));
+        _sched_changed = false;
         _tg.create_thread(boost::bind(&socket_msg_impl::serve, this));
 
         //make the blocks
@@ -208,12 +211,40 @@ public:
         _tg.join_all();
     }
 
+    void set_processor_affinity(const std::vector<int> &cpus)
+    {
+        _consumer->set_processor_affinity(cpus);
+        _producer->set_processor_affinity(cpus);
+        boost::mutex::scoped_lock lock(_sched_mutex);
+        _sched.affinity = cpus;
+        _sched_changed = true;
+    }
+
+    void set_thread_priority(const double priority, const bool realtime)
+    {
+        _consumer->set_thread_priority(priority, realtime);
+        _producer->set_thread_priority(priority, realtime);
+        boost::mutex::scoped_lock lock(_sched_mutex);
+        _sched.priority = priority;
+        _sched.realtime = realtime;
+        _sched.has_priority = true;
+        _sched_changed = true;
+    }
+
 private:
 
     void serve(void)
     {
         while (not boost::this_thread::interruption_requested())
         {
+            //the acceptor thread is already running, apply new settings here
+            if (_sched_changed)
+            {
+                boost::mutex::scoped_lock lock(_sched_mutex);
+                _sched.apply();
+                _sched_changed = false;
+            }
+
             if (!wait_for_recv_ready(_acceptor->native())) continue;
             boost::shared_ptr<asio::ip::tcp::socket> socket(new asio::ip::tcp::socket(*_io_service));
             _acceptor->accept(*socket);
@@ -225,6 +256,9 @@ private:
     }
 
     boost::thread_group _tg;
+    boost::mutex _sched_mutex;
+    thread_sched _sched;
+    boost::atomic<bool> _sched_changed;
     boost::shared_ptr<asio::io_service> _io_service;
     boost::shared_ptr<asio::ip::tcp::acceptor> _acceptor;
 
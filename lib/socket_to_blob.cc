@@ -31,6 +31,7 @@ using namespace gnuradio::extras;
 static const long timeout_us = 100*1000; //100ms
 static const pmt::pmt_t BLOB_KEY = pmt::pmt_string_to_symbol("blob_stream");
 static const size_t POOL_SIZE = 64; //num pre-allocated blobs to acquire at once
+static const size_t BATCH_SIZE = 32; //max num blobs to post at once
 
 static bool wait_for_recv_ready(int sock_fd){
     //setup timeval for timeout
@@ -47,6 +48,15 @@ static bool wait_for_recv_ready(int sock_fd){
     return ::select(sock_fd+1, &rset, NULL, NULL, &tv) > 0;
 }
 
+static gr_tag_t make_blob_msg(const pmt::pmt_t &blob, const pmt::pmt_t &id){
+    gr_tag_t msg;
+    msg.offset = 0; //not used
+    msg.key = BLOB_KEY;
+    msg.value = blob;
+    msg.srcid = id;
+    return msg;
+}
+
 /***********************************************************************
  * UDP Implementation
  **********************************************************************/
@@ -85,16 +95,22 @@ public:
         while (!boost::this_thread::interruption_requested()){
             if (!wait_for_recv_ready(_socket->native())) continue;
 
-            //perform a blocking receive
-            pmt::pmt_t blob = _mgr->acquire(true /*block*/);
-            pmt::pmt_blob_resize(blob, _mtu);
-            const size_t num_bytes = _socket->receive(asio::buffer(
-                pmt::pmt_blob_rw_data(blob), _mtu
-            ));
-
-            //post the message to downstream subscribers
-            pmt::pmt_blob_resize(blob, num_bytes);
-            this->post_msg(0, BLOB_KEY, blob, _id);
+            //receive every datagram that is already waiting, up to a batch
+            do{
+                //only block on the pool for the first blob of a batch
+                pmt::pmt_t blob = _mgr->acquire(_msgs.empty());
+                if (blob == pmt::PMT_NIL) break;
+                pmt::pmt_blob_resize(blob, _mtu);
+                const size_t num_bytes = _socket->receive(asio::buffer(
+                    pmt::pmt_blob_rw_data(blob), _mtu
+                ));
+                pmt::pmt_blob_resize(blob, num_bytes);
+                _msgs.push_back(make_blob_msg(blob, _id));
+            } while (_msgs.size() < BATCH_SIZE && _socket->available() != 0);
+
+            //post the messages to downstream subscribers
+            this->post_msgs(0, _msgs);
+            _msgs.clear();
         }
         return -1;
     }
@@ -102,6 +118,7 @@ public:
 private:
     asio::io_service _io_service;
     boost::shared_ptr<asio::ip::udp::socket> _socket;
+    std::vector<gr_tag_t> _msgs;
     const size_t _mtu;
     pmt::pmt_t _id;
     pmt::pmt_mgr::sptr _mgr;
@@ -161,16 +178,22 @@ public:
             if (!_accepted) this->accept();
             if (!wait_for_recv_ready(_socket->native())) continue;
 
-            //perform a blocking receive
-            pmt::pmt_t blob = _mgr->acquire(true /*block*/);
-            pmt::pmt_blob_resize(blob, _mtu);
-            const size_t num_bytes = _socket->receive(asio::buffer(
-                pmt::pmt_blob_rw_data(blob), _mtu
-            ));
-
-            //post the message to downstream subscribers
-            pmt::pmt_blob_resize(blob, num_bytes);
-            this->post_msg(0, BLOB_KEY, blob, _id);
+            //receive everything that is already waiting, up to a batch
+            do{
+                //only block on the pool for the first blob of a batch
+                pmt::pmt_t blob = _mgr->acquire(_msgs.empty());
+                if (blob == pmt::PMT_NIL) break;
+                pmt::pmt_blob_resize(blob, _mtu);
+                const size_t num_bytes = _socket->receive(asio::buffer(
+                    pmt::pmt_blob_rw_data(blob), _mtu
+                ));
+                pmt::pmt_blob_resize(blob, num_bytes);
+                _msgs.push_back(make_blob_msg(blob, _id));
+            } while (_msgs.size() < BATCH_SIZE && _socket->available() != 0);
+
+            //post the messages to downstream subscribers
+            this->post_msgs(0, _msgs);
+            _msgs.clear();
         }
         return -1;
     }
@@ -183,6 +206,7 @@ private:
     pmt::pmt_t _id;
     pmt::pmt_mgr::sptr _mgr;
     bool _accepted;
+    std::vector<gr_tag_t> _msgs;
 };
 
 /***********************************************************************
@@ -21,12 +21,55 @@
 
 #include <gnuradio/extras/subtract.h>
 #include <gr_io_signature.h>
+#include "op_kernels.h"
+#include "work_pool.h"
 #include <stdexcept>
 #include <complex>
-#include <volk/volk.h>
+#include <boost/atomic.hpp>
 
 using namespace gnuradio::extras;
 
+/***********************************************************************
+ * Kernel selection, only the 8 and 16 bit integers saturate
+ **********************************************************************/
+template <typename type>
+static void subtract_items(type *out, const type *const *in, const size_t m, const size_t n, const bool){
+    gnuradio::kernels::subtract(out, in, m, n);
+}
+
+template <typename type>
+static void subtract_sat_items(type *out, const type *const *in, const size_t m, const size_t n, const bool saturate){
+    if (saturate) gnuradio::kernels::subtract_sat(out, in, m, n);
+    else gnuradio::kernels::subtract(out, in, m, n);
+}
+
+static void subtract_items(int8_t *out, const int8_t *const *in, const size_t m, const size_t n, const bool saturate){
+    subtract_sat_items(out, in, m, n, saturate);
+}
+
+static void subtract_items(int16_t *out, const int16_t *const *in, const size_t m, const size_t n, const bool saturate){
+    subtract_sat_items(out, in, m, n, saturate);
+}
+
+template <typename type>
+static void negate_items(type *out, const type *in, const size_t n, const bool){
+    gnuradio::kernels::negate(out, in, n);
+}
+
+template <typename type>
+static void negate_sat_items(type *out, const type *in, const size_t n, const bool saturate){
+    if (saturate) gnuradio::kernels::negate_sat(out, in, n);
+    else gnuradio::kernels::negate(out, in, n);
+}
+
+static void negate_items(int8_t *out, const int8_t *in, const size_t n, const bool saturate){
+    negate_sat_items(out, in, n, saturate);
+}
+
+static void negate_items(int16_t *out, const int16_t *in, const size_t n, const bool saturate){
+    negate_sat_items(out, in, n, saturate);
+}
+
 /***********************************************************************
  * Generic subtracter implementation
  **********************************************************************/
@@ -39,9 +82,15 @@ public:
             gr_make_io_signature (num_inputs, num_inputs, sizeof(type)*vlen),
             gr_make_io_signature (1, 1, sizeof(type)*vlen)
         ),
-        _vlen(vlen)
+        _vlen(vlen),
+        _ins(num_inputs),
+        _saturate(false)
     {
-        //NOP
+        this->set_inplace(true); //out[i] = f(in0[i], ...)
+    }
+
+    void set_saturate(const bool saturate){
+        _saturate.store(saturate, boost::memory_order_relaxed);
     }
 
     int work(
@@ -55,31 +104,31 @@ public:
             type *out = output_items[0].cast<type *>();
             const type *in = input_items[0].cast<const type *>();
 
-            for (size_t i = 0; i < n_nums; i++){
-                out[i] = -in[i];
-            }
+            negate_items(out, in, n_nums, _saturate.load(boost::memory_order_relaxed));
 
             return noutput_items;
         }
         else {
-            const size_t n_nums = noutput_items * _vlen;
-            type *out = output_items[0].cast<type *>();
-            const type *in0 = input_items[0].cast<const type *>();
-
-            for (size_t n = 1; n < input_items.size(); n++){
-                const type *in = input_items[n].cast<const type *>();
-                for (size_t i = 0; i < n_nums; i++){
-                    out[i] = in0[i] - in[i];
-                }
-                in0 = out; //for next input, we do output -= input
+            for (size_t n = 0; n < input_items.size(); n++){
+                _ins[n] = input_items[n].cast<const type *>();
             }
 
+            //one pass over all inputs, output = input0 - input1 - ...
+            const size_t n_nums = noutput_items * _vlen;
+            const size_t split = this->work_split();
+            gnuradio::parallel_nary(
+                &subtract_items, output_items[0].cast<type *>(), &_ins[0], _ins.size(), n_nums,
+                _saturate.load(boost::memory_order_relaxed), split != 0 && noutput_items >= split, _chunk_ins
+            );
             return noutput_items;
         }
     }
 
 private:
     const size_t _vlen;
+    std::vector<const type *> _ins;
+    std::vector<const type *> _chunk_ins;
+    boost::atomic<bool> _saturate;
 };
 
 /***********************************************************************
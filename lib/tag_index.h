@@ -0,0 +1,213 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_TAG_INDEX_H
+#define INCLUDED_GR_EXTRAS_TAG_INDEX_H
+
+#include <gr_tags.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace gnuradio{
+
+/*!
+ * A cache of the tags on one input port, indexed by key and offset.
+ *
+ * The core get_tags_in_range() scans every tag in the buffer per call.
+ * The index takes the tags of the work window with one scan,
+ * then serves each query with a binary search over the tags of the key.
+ * Tags before the read pointer are dropped as the port is consumed.
+ */
+class tag_index
+{
+public:
+    tag_index(void):
+        _begin(0), _end(0), _head(0), _seq(0)
+    {
+        //NOP
+    }
+
+    //! Drop the tags before the read pointer, call at the start of work
+    void prune(const uint64_t nread)
+    {
+        while (_head < _all.size() && _all[_head].offset < nread) _head++;
+        for (size_t i = 0; i < _keys.size(); i++)
+        {
+            key_lane &lane = _keys[i];
+            while (lane.head < lane.seqs.size() && lane.seqs[lane.head] < _seq + _head) lane.head++;
+        }
+
+        //compact once half of the storage is dropped tags
+        if (_head > _all.size()/2) this->compact();
+
+        _begin = nread;
+        _end = std::max(_end, nread);
+    }
+
+    //! The cached offsets are [begin, end)
+    uint64_t begin(void) const
+    {
+        return _begin;
+    }
+
+    uint64_t end(void) const
+    {
+        return _end;
+    }
+
+    //! Add the tags of [end(), new_end) as returned by the core, takes the tags
+    void fill(std::vector<gr_tag_t> &tags, const uint64_t new_end)
+    {
+        //the core returns tags in the order they were added,
+        //which is almost always offset order already
+        if (!is_sorted(tags)) std::stable_sort(tags.begin(), tags.end(), offset_less);
+
+        //the usual case: the last window was consumed, take the tags as is
+        if (_head == _all.size())
+        {
+            this->compact();
+            _all.swap(tags);
+            for (size_t i = 0; i < _all.size(); i++)
+            {
+                this->lane(_all[i].key).seqs.push_back(_seq + i);
+            }
+        }
+        else for (size_t i = 0; i < tags.size(); i++)
+        {
+            this->lane(tags[i].key).seqs.push_back(_seq + _all.size());
+            _all.push_back(tags[i]);
+        }
+        _end = new_end;
+    }
+
+    //! Append the cached tags in [start, end) to tags, in offset order
+    void get(std::vector<gr_tag_t> &tags, const uint64_t start, const uint64_t end) const
+    {
+        std::vector<gr_tag_t>::const_iterator it = std::lower_bound(
+            _all.begin() + _head, _all.end(), start, offset_below);
+        for (; it != _all.end() && it->offset < end; ++it) tags.push_back(*it);
+    }
+
+    //! Append the cached tags in [start, end) with the given key
+    void get(
+        std::vector<gr_tag_t> &tags,
+        const uint64_t start,
+        const uint64_t end,
+        const pmt::pmt_t &key
+    ) const
+    {
+        const key_lane *lane = this->find(key);
+        if (lane == NULL) return;
+
+        //binary search the sequence numbers of the key by offset
+        size_t lo = lane->head, hi = lane->seqs.size();
+        while (lo < hi)
+        {
+            const size_t mid = lo + (hi - lo)/2;
+            if (this->at(lane->seqs[mid]).offset < start) lo = mid + 1;
+            else hi = mid;
+        }
+        for (; lo < lane->seqs.size(); lo++)
+        {
+            const gr_tag_t &tag = this->at(lane->seqs[lo]);
+            if (tag.offset >= end) break;
+            tags.push_back(tag);
+        }
+    }
+
+private:
+    //! the tags of a key, as sequence numbers into the storage
+    struct key_lane
+    {
+        key_lane(void): head(0){}
+        pmt::pmt_t key;
+        std::vector<uint64_t> seqs;
+        size_t head;
+    };
+
+    static bool offset_less(const gr_tag_t &lhs, const gr_tag_t &rhs)
+    {
+        return lhs.offset < rhs.offset;
+    }
+
+    static bool offset_below(const gr_tag_t &tag, const uint64_t offset)
+    {
+        return tag.offset < offset;
+    }
+
+    static bool is_sorted(const std::vector<gr_tag_t> &tags)
+    {
+        for (size_t i = 1; i < tags.size(); i++)
+        {
+            if (tags[i].offset < tags[i-1].offset) return false;
+        }
+        return true;
+    }
+
+    const gr_tag_t &at(const uint64_t seq) const
+    {
+        return _all[size_t(seq - _seq)];
+    }
+
+    void compact(void)
+    {
+        _all.erase(_all.begin(), _all.begin() + _head);
+        _seq += _head;
+        _head = 0;
+        for (size_t i = 0; i < _keys.size(); i++)
+        {
+            key_lane &lane = _keys[i];
+            lane.seqs.erase(lane.seqs.begin(), lane.seqs.begin() + lane.head);
+            lane.head = 0;
+        }
+    }
+
+    //! there are few keys, so a linear search wins
+    const key_lane *find(const pmt::pmt_t &key) const
+    {
+        for (size_t i = 0; i < _keys.size(); i++)
+        {
+            if (pmt::pmt_eqv(_keys[i].key, key)) return &_keys[i];
+        }
+        return NULL;
+    }
+
+    key_lane &lane(const pmt::pmt_t &key)
+    {
+        const key_lane *lane = this->find(key);
+        if (lane != NULL) return const_cast<key_lane &>(*lane);
+        _keys.push_back(key_lane());
+        _keys.back().key = key;
+        return _keys.back();
+    }
+
+    uint64_t _begin;
+    uint64_t _end;
+    std::vector<gr_tag_t> _all;
+    size_t _head; //first live tag in _all
+    uint64_t _seq; //sequence number of _all[0]
+    std::vector<key_lane> _keys;
+};
+
+} //namespace gnuradio
+
+#endif /* INCLUDED_GR_EXTRAS_TAG_INDEX_H */
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_THREAD_SCHED_H
+#define INCLUDED_GR_EXTRAS_THREAD_SCHED_H
+
+#include <iostream>
+#include <vector>
+
+//! Set the processors that the calling thread may run on
+static inline void set_this_thread_affinity(const std::vector<int> &cpus);
+
+/*!
+ * Set the scheduling priority of the calling thread.
+ * \param priority -1.0 (lowest) to 1.0 (highest), 0.0 is normal
+ * \param realtime true for a realtime scheduling class
+ */
+static inline void set_this_thread_priority(const double priority, const bool realtime);
+
+//! The scheduling settings for the threads of one block
+struct thread_sched
+{
+    thread_sched(void):
+        priority(0.0), realtime(false), has_priority(false)
+    {
+        //NOP
+    }
+
+    //! apply the settings to the calling thread, called from start()
+    void apply(void) const
+    {
+        if (!affinity.empty()) set_this_thread_affinity(affinity);
+        if (has_priority) set_this_thread_priority(priority, realtime);
+    }
+
+    std::vector<int> affinity;
+    double priority;
+    bool realtime;
+    bool has_priority;
+};
+
+#ifdef _WIN32
+#include <windows.h>
+
+static inline void set_this_thread_affinity(const std::vector<int> &cpus)
+{
+    DWORD_PTR mask = 0;
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        if (cpus[i] >= 0 && cpus[i] < int(sizeof(mask)*8)) mask |= DWORD_PTR(1) << cpus[i];
+    }
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+    {
+        std::cerr << "extras: failed to set thread affinity" << std::endl;
+    }
+}
+
+static inline void set_this_thread_priority(const double priority, const bool realtime)
+{
+    int level = THREAD_PRIORITY_NORMAL;
+    if (realtime && priority > 0.0) level = THREAD_PRIORITY_TIME_CRITICAL;
+    else if (priority > 0.5) level = THREAD_PRIORITY_HIGHEST;
+    else if (priority > 0.0) level = THREAD_PRIORITY_ABOVE_NORMAL;
+    else if (priority < -0.5) level = THREAD_PRIORITY_LOWEST;
+    else if (priority < 0.0) level = THREAD_PRIORITY_BELOW_NORMAL;
+    if (SetThreadPriority(GetCurrentThread(), level) == 0)
+    {
+        std::cerr << "extras: failed to set thread priority" << std::endl;
+    }
+}
+
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static inline void set_this_thread_affinity(const std::vector<int> &cpus)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+        std::cerr << "extras: failed to set thread affinity" << std::endl;
+    }
+#else
+    (void)cpus;
+    std::cerr << "extras: thread affinity is not supported on this platform" << std::endl;
+#endif
+}
+
+static inline void set_this_thread_priority(const double priority_, const bool realtime)
+{
+    const double priority = std::max(-1.0, std::min(1.0, priority_));
+
+    //realtime: a round robin priority scaled into the allowed range
+    if (realtime && priority > 0.0)
+    {
+        const int min = sched_get_priority_min(SCHED_RR);
+        const int max = sched_get_priority_max(SCHED_RR);
+        sched_param param;
+        param.sched_priority = min + int(priority*(max - min) + 0.5);
+        if (pthread_setschedparam(pthread_self(), SCHED_RR, &param) != 0)
+        {
+            std::cerr << "extras: failed to set realtime thread priority (permissions?)" << std::endl;
+        }
+        return;
+    }
+
+#ifdef __linux__
+    //normal: the nice value applies per thread on linux
+    const int nice = -int(priority*20);
+    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice) != 0)
+    {
+        std::cerr << "extras: failed to set thread priority (permissions?)" << std::endl;
+    }
+#else
+    if (priority != 0.0)
+    {
+        std::cerr << "extras: non-realtime thread priority is not supported on this platform" << std::endl;
+    }
+#endif
+}
+
+#endif
+
+#endif /* INCLUDED_GR_EXTRAS_THREAD_SCHED_H */
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "work_pool.h"
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace gnuradio;
+
+//! One call to parallel_for, it lives on the stack of the caller
+struct work_pool::job
+{
+    const range_fn *fn;
+    size_t n;
+    size_t grain;
+    size_t next; //!< the start of the next unclaimed chunk
+    size_t running; //!< chunks claimed but not yet finished
+};
+
+static size_t default_num_threads(void)
+{
+    const char *env = std::getenv("EXTRAS_WORK_THREADS");
+    if (env != NULL) return size_t(std::max(0, std::atoi(env)));
+    const size_t cpus = boost::thread::hardware_concurrency();
+    return (cpus > 1)? cpus - 1 : 0;
+}
+
+work_pool &work_pool::shared(void)
+{
+    static work_pool pool(default_num_threads());
+    return pool;
+}
+
+work_pool::work_pool(const size_t num_threads):
+    _num_threads(num_threads), _stopping(false)
+{
+    for (size_t i = 0; i < _num_threads; i++)
+    {
+        _threads.create_thread(boost::bind(&work_pool::worker, this));
+    }
+}
+
+work_pool::~work_pool(void)
+{
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _stopping = true;
+    }
+    _work_cond.notify_all();
+    _threads.join_all();
+}
+
+size_t work_pool::num_threads(void) const
+{
+    return _num_threads;
+}
+
+void work_pool::parallel_for(const size_t n, const size_t grain_, const range_fn &fn)
+{
+    const size_t grain = std::max<size_t>(grain_, 1);
+    if (_num_threads == 0 || n <= grain)
+    {
+        fn(0, n);
+        return;
+    }
+
+    job j;
+    j.fn = &fn;
+    j.n = n;
+    j.grain = grain;
+    j.next = 0;
+    j.running = 0;
+
+    boost::mutex::scoped_lock lock(_mutex);
+    _jobs.push_back(&j);
+    _work_cond.notify_all();
+
+    //help out until every chunk is claimed, then wait for the stragglers
+    while (j.next < j.n) this->run_chunk(j, lock);
+    while (j.running != 0) _done_cond.wait(lock);
+}
+
+void work_pool::run_chunk(job &j, boost::mutex::scoped_lock &lock)
+{
+    //claim the next chunk, the last claim takes the job off the list
+    const size_t begin = j.next;
+    const size_t end = std::min(j.n, begin + j.grain);
+    j.next = end;
+    j.running++;
+    if (end == j.n) _jobs.erase(std::find(_jobs.begin(), _jobs.end(), &j));
+
+    lock.unlock();
+    (*j.fn)(begin, end);
+    lock.lock();
+
+    //the caller may return and pop the job once the last chunk is done
+    if (--j.running == 0 && j.next == j.n) _done_cond.notify_all();
+}
+
+void work_pool::worker(void)
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    while (!_stopping)
+    {
+        if (_jobs.empty()) _work_cond.wait(lock);
+        else this->run_chunk(*_jobs.front(), lock);
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_EXTRAS_WORK_POOL_H
+#define INCLUDED_GR_EXTRAS_WORK_POOL_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace gnuradio{
+
+/*!
+ * A pool of threads that splits one call to work() into chunks.
+ *
+ * parallel_for() hands out the chunks of a range to the pool threads,
+ * and the calling thread takes chunks as well, so it never sits idle.
+ * It returns once every chunk is done, so the caller owns its buffers
+ * again, and work() keeps its usual single threaded contract.
+ *
+ * Several blocks may call into the same pool at once,
+ * their chunks are taken in the order that the calls came in.
+ * A chunk is one lock to claim and one lock to finish,
+ * so chunks should be many microseconds of work, see work_grain().
+ */
+class work_pool : boost::noncopyable
+{
+public:
+    //! A function of the range [begin, end), it must not throw
+    typedef boost::function<void(const size_t, const size_t)> range_fn;
+
+    /*!
+     * The pool shared by all blocks, started on first use.
+     * It has one thread per processor less one for the caller,
+     * the environment variable EXTRAS_WORK_THREADS overrides the count.
+     */
+    static work_pool &shared(void);
+
+    //! Make a pool with this many threads besides the callers
+    work_pool(const size_t num_threads);
+
+    //! Stop and join the threads, no call may be in progress
+    ~work_pool(void);
+
+    //! The number of threads besides the callers, 0 runs inline
+    size_t num_threads(void) const;
+
+    /*!
+     * Call fn over [0, n) in chunks of grain, across the pool.
+     * Runs fn(0, n) inline when there is only one chunk or no threads.
+     * \param n the size of the whole range
+     * \param grain the size of a chunk, the last one may be shorter
+     * \param fn called once per chunk, from any of the threads
+     */
+    void parallel_for(const size_t n, const size_t grain, const range_fn &fn);
+
+private:
+    struct job;
+    void worker(void);
+    void run_chunk(job &j, boost::mutex::scoped_lock &lock);
+
+    boost::mutex _mutex;
+    boost::condition_variable _work_cond;
+    boost::condition_variable _done_cond;
+    std::deque<job *> _jobs;
+    boost::thread_group _threads;
+    size_t _num_threads;
+    bool _stopping;
+};
+
+/*!
+ * The number of numbers per chunk of a call over n numbers.
+ * About four chunks per thread, so that a thread that starts late
+ * does not hold up the call, but never less than 256 KiB of memory traffic,
+ * tens of microseconds, so that the two locks of a chunk stay cheap.
+ * Chunks are whole multiples of 64 numbers, so the edges land on whole SIMD vectors.
+ * \param n the numbers in the whole call
+ * \param bytes_per_num the bytes of one number summed over every input and output
+ * \param num_threads the threads of the pool, besides the caller
+ */
+static inline size_t work_grain(const size_t n, const size_t bytes_per_num, const size_t num_threads)
+{
+    const size_t min_grain = (256*1024)/bytes_per_num;
+    const size_t even_grain = n/(4*(num_threads + 1));
+    const size_t grain = (even_grain > min_grain)? even_grain : min_grain;
+    return (grain < 64)? 64 : grain - grain%64;
+}
+
+//! One N-ary kernel call, out[i] = f(in[0][i], in[1][i], ...), cut into chunks
+template <typename type, typename flag_type>
+struct nary_work
+{
+    typedef void (*kernel_fn)(type *, const type *const *, const size_t, const size_t, const flag_type);
+
+    void operator()(const size_t begin, const size_t end) const
+    {
+        kernel(out + begin, chunk_ins + (begin/grain)*m, m, end - begin, flag);
+    }
+
+    kernel_fn kernel;
+    type *out;
+    const type *const *chunk_ins; //!< m input pointers per chunk, offset to the chunk
+    size_t m;
+    size_t grain;
+    flag_type flag;
+};
+
+/*!
+ * Call an N-ary kernel over n numbers, in chunks across the shared pool when split is set.
+ * Blocks pass split when the call has at least work_split() items.
+ * \param chunk_ins scratch for the input pointers of every chunk, kept by the block
+ */
+template <typename type, typename flag_type>
+void parallel_nary(
+    typename nary_work<type, flag_type>::kernel_fn kernel,
+    type *out, const type *const *in, const size_t m, const size_t n,
+    const flag_type flag, const bool split, std::vector<const type *> &chunk_ins
+){
+    work_pool &pool = work_pool::shared();
+    const size_t grain = work_grain(n, sizeof(type)*(m + 1), pool.num_threads());
+    if (!split || pool.num_threads() == 0 || n <= grain)
+    {
+        kernel(out, in, m, n, flag);
+        return;
+    }
+
+    //the input pointers of each chunk are set up once, before the threads start
+    const size_t num_chunks = (n + grain - 1)/grain;
+    chunk_ins.resize(num_chunks*m);
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        for (size_t k = 0; k < m; k++) chunk_ins[c*m + k] = in[k] + c*grain;
+    }
+
+    nary_work<type, flag_type> w;
+    w.kernel = kernel;
+    w.out = out;
+    w.chunk_ins = &chunk_ins[0];
+    w.m = m;
+    w.grain = grain;
+    w.flag = flag;
+    pool.parallel_for(n, grain, w);
+}
+
+} //namespace gnuradio
+
+#endif /* INCLUDED_GR_EXTRAS_WORK_POOL_H */
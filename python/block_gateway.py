@@ -96,7 +96,22 @@ class gateway_block(object):
         prefix = 'gr_block__'
         for attr in [x for x in dir(self.__gateway) if x.startswith(prefix)]:
             setattr(self, attr.replace(prefix, ''), getattr(self.__gateway, attr))
-        self.pop_msg_queue = lambda: extras_swig.gr_block_gw_pop_msg_queue_safe(self.__gateway)
+        self.pop_msg_queue_batch = lambda max, timeout=-1.0: \
+            extras_swig.gr_block_gw_pop_msg_queue_batch_safe(self.__gateway, max, timeout)
+        self.wait_msg_or_input = lambda timeout=-1.0: \
+            extras_swig.gr_block_gw_wait_msg_or_input_safe(self.__gateway, timeout)
+        self.pop_msg_queue = self.__pop_msg_queue
+
+    def __pop_msg_queue(self, timeout=None):
+        """
+        Pop a message from the front of the queue.
+        Blocks forever when timeout is None,
+        otherwise returns None after timeout seconds without a message.
+        """
+        if timeout is None: return extras_swig.gr_block_gw_pop_msg_queue_safe(self.__gateway)
+        msgs = self.pop_msg_queue_batch(1, timeout)
+        if msgs: return msgs[0]
+        return None
 
     def to_basic_block(self):
         """
@@ -202,7 +217,7 @@ class decim_block(gateway_block):
             out_sig=out_sig,
             **kwargs
         )
-        self.set_relative_rate(1.0/decim)
+        self.set_rate(1, decim)
 
 class interp_block(gateway_block):
     def __init__(self, name, in_sig, out_sig, interp, **kwargs):
@@ -212,7 +227,7 @@ class interp_block(gateway_block):
             out_sig=out_sig,
             **kwargs
         )
-        self.set_relative_rate(1.0*interp)
+        self.set_rate(interp, 1)
 
 #inject into gr namespace
 gr.basic_block = basic_block
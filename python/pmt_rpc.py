@@ -27,6 +27,7 @@ except ImportError: from gruel import pmt
 from gnuradio import gr
 import pmt_to_python #injects into pmt
 import block_gateway #needed to inject into gr
+import extras_swig
 
 class pmt_rpc(gr.block):
     """
@@ -82,7 +83,7 @@ class pmt_rpc(gr.block):
             result = self.handle_request(pmt.to_python(msg.key), pmt.to_python(msg.value))
             try: msg.value = pmt.from_python(result)
             except Exception as ex: msg.value = pmt.from_python(str(ex))
-            if self._result_msg: self.post_msg(0, msg)
+            if self._result_msg: self.post_msg(0, msg, extras_swig.MSG_PRIORITY_CONTROL)
 
     @staticmethod
     def _exec_arg(arg):
@@ -151,6 +151,93 @@ class test_add_and_friends (gr_unittest.TestCase):
         self.help_ff ((src1_data, src2_data),
                       expected_result, op)
 
+    def test_mult_ff_work_split (self):
+        #every call is split across the work pool, the result is the same
+        src_data = [tuple([float((i*k)%7 - 3) for i in range(20000)]) for k in (1, 2, 3)]
+        expected_result = tuple([a*b*c for a, b, c in zip(*src_data)])
+        op = extras.multiply_f32_f32(3)
+        op.set_work_split(1)
+        self.assertEqual(op.work_split(), 1)
+        self.help_ff (src_data, expected_result, op)
+
+    def test_add_ss_wraps (self):
+        src1_data = [(i*977)%65536 - 32768 for i in range(1000)]
+        src2_data = [(i*131)%65536 - 32768 for i in range(1000)]
+        expected_result = tuple([(a+b+32768)%65536 - 32768 for a, b in zip(src1_data, src2_data)])
+        src1 = gr.vector_source_s (src1_data)
+        src2 = gr.vector_source_s (src2_data)
+        op = extras.add_s16_s16(2)
+        dst = gr.vector_sink_s ()
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_add_ss_saturate (self):
+        src1_data = [(i*977)%65536 - 32768 for i in range(1000)]
+        src2_data = [(i*131)%65536 - 32768 for i in range(1000)]
+        expected_result = tuple([min(max(a+b, -32768), 32767) for a, b in zip(src1_data, src2_data)])
+        src1 = gr.vector_source_s (src1_data)
+        src2 = gr.vector_source_s (src2_data)
+        op = extras.add_s16_s16(2)
+        op.set_saturate(True)
+        dst = gr.vector_sink_s ()
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_add_ff_many (self):
+        src_data = [[float(i*k % 17) for i in range(1000)] for k in range(1, 10)]
+        expected_result = tuple([float(sum(col)) for col in zip(*src_data)])
+        op = extras.add_f32_f32(len(src_data))
+        self.help_ff (src_data, expected_result, op)
+
+    def test_mult_sc16 (self):
+        #interleaved I and Q, the product is a complex multiply
+        src1_data = (1, 2, 3, -4)
+        src2_data = (5, 6, 7, 8)
+        expected_result = (-7, 16, 53, -4)
+        src1 = gr.vector_source_s (src1_data, False, 2)
+        src2 = gr.vector_source_s (src2_data, False, 2)
+        op = extras.multiply_sc16_sc16(2)
+        dst = gr.vector_sink_s (2)
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_mult_sc16_q15 (self):
+        #Q15 complex multiply, -1-1j squared clamps the imaginary part
+        src1_data = (16384, 0, -32768, -32768)
+        src2_data = (16384, 16384, -32768, -32768)
+        expected_result = (8192, 8192, 0, 32767)
+        src1 = gr.vector_source_s (src1_data, False, 2)
+        src2 = gr.vector_source_s (src2_data, False, 2)
+        op = extras.multiply_sc16_sc16(2)
+        op.set_saturate(True)
+        dst = gr.vector_sink_s (2)
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_mult_const_ss_q15 (self):
+        #16384 is 0.5 in Q15, products round to nearest
+        src_data = (-32768, 100, 32767, 3)
+        expected_result = (-16384, 50, 16384, 2)
+        src = gr.vector_source_s (src_data)
+        op = extras.multiply_const_s16_s16(16384)
+        op.set_saturate(True)
+        dst = gr.vector_sink_s ()
+        self.tb.connect (src, op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
     def test_sub_ii_1 (self):
         src1_data = (1,  2, 3, 4, 5)
         expected_result = (-1, -2, -3, -4, -5)
@@ -181,6 +268,188 @@ class test_add_and_friends (gr_unittest.TestCase):
         self.help_ff ((src1_data, src2_data),
                       expected_result, op)
 
+    def test_div_ff_fast (self):
+        src1_data = [float(i + 1) for i in range(20)]
+        src2_data = [0.5 + 0.25*i for i in range(20)]
+        expected_result = [a/b for a, b in zip(src1_data, src2_data)]
+        op = extras.divide_f32_f32(2)
+        op.set_fast_reciprocal(True)
+        src1 = gr.vector_source_f (src1_data)
+        src2 = gr.vector_source_f (src2_data)
+        dst = gr.vector_sink_f ()
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertFloatTuplesAlmostEqual (expected_result, dst.data (), 5)
+
+    def test_div_cc (self):
+        src1_data       = (1+2j, 10+0j, -4+6j)
+        src2_data       = (1-1j,  2+0j,    2j)
+        expected_result = (-0.5+1.5j, 5+0j, 3+2j)
+        op = extras.divide_fc32_fc32(2)
+        self.help_cc ((src1_data, src2_data),
+                      expected_result, op)
+
+    def test_div_sc16 (self):
+        #interleaved I and Q, integer quotients truncate
+        src1_data = (7, 1, 100, -50)
+        src2_data = (1, 2, 10, 0)
+        expected_result = (1, -2, 10, -5)
+        src1 = gr.vector_source_s (src1_data, False, 2)
+        src2 = gr.vector_source_s (src2_data, False, 2)
+        op = extras.divide_sc16_sc16(2)
+        dst = gr.vector_sink_s (2)
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_const_v_periodic (self):
+        #many items, so the constant pattern repeats across work calls
+        vec = [3, -2, 5]
+        src_data = [i % 101 - 50 for i in range(3*5000)]
+        mult_result = tuple([x*vec[i%3] for i, x in enumerate(src_data)])
+        add_result = tuple([complex(x + vec[i%3]) for i, x in enumerate(src_data)])
+        src1 = gr.vector_source_s (src_data, False, 3)
+        mult = extras.multiply_const_v_s16_s16(vec)
+        dst1 = gr.vector_sink_s (3)
+        src2 = gr.vector_source_c (src_data, False, 3)
+        add = extras.add_const_v_fc32_fc32(vec)
+        dst2 = gr.vector_sink_c (3)
+        self.tb.connect (src1, mult, dst1)
+        self.tb.connect (src2, add, dst2)
+        self.tb.run ()
+        self.assertEqual (mult_result, dst1.data ())
+        self.assertEqual (add_result, dst2.data ())
+
+    def test_prime_lengths (self):
+        #odd sized buffers need no output multiple or aligned kernels
+        for n in (1, 7, 13, 1009):
+            tb = gr.top_block ()
+            src_data = [complex(i, -i) for i in range(n)]
+            src = gr.vector_source_c (src_data)
+            mult = extras.multiply_const_fc32_fc32(2j)
+            add = extras.add_fc32_fc32(2)
+            dst = gr.vector_sink_c ()
+            tb.connect (src, mult, (add, 0))
+            tb.connect (src, (add, 1))
+            tb.connect (add, dst)
+            tb.run ()
+            self.assertEqual (tuple([x*2j + x for x in src_data]), dst.data ())
+
+    def test_convert_sc16_fc32 (self):
+        src_data = (16384, -32768, 0, 8192)
+        expected_result = (0.5-1j, 0.25j)
+        src = gr.vector_source_s (src_data, False, 2)
+        op = extras.convert_sc16_fc32(1.0/32768)
+        dst = gr.vector_sink_c ()
+        self.tb.connect (src, op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_convert_fc32_sc16 (self):
+        #rounds to nearest even and clamps instead of wrapping
+        src_data = (0.5+2j, -1-0.25j)
+        expected_result = (16384, 32767, -32767, -8192)
+        src = gr.vector_source_c (src_data)
+        op = extras.convert_fc32_sc16(32767)
+        dst = gr.vector_sink_s (2)
+        self.tb.connect (src, op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_convert_fc32_sc32_overdriven (self):
+        #saturates to the int32 limits, long enough for the vector path
+        src_data = (1e10-1e10j, 2.0**31+float('inf')*1j, 0.5+1.5j, -2.0**31-float('inf')*1j)*20
+        expected_result = (2147483647, -2147483648, 2147483647, 2147483647, 0, 2, -2147483648, -2147483648)*20
+        src = gr.vector_source_c (src_data)
+        op = extras.convert_fc32_sc32(1.0)
+        dst = gr.vector_sink_i (2)
+        self.tb.connect (src, op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_expression_ff (self):
+        src1_data = [float(i) for i in range(3000)]
+        src2_data = [float(i % 7) for i in range(3000)]
+        expected_result = tuple([2*a + (a - 1)*b + 0.5 for a, b in zip(src1_data, src2_data)])
+        op = extras.expression_f32_f32("2*in0 + (in0 - 1)*in1 + 1/2", 2)
+        self.help_ff ((src1_data, src2_data), expected_result, op)
+
+    def test_expression_cc (self):
+        src1_data       = (1+1j, 2-1j, 0+3j)
+        src2_data       = (1+0j, 0+1j, 2+2j)
+        expected_result = tuple([(1-2j)*a + a/b - 1j for a, b in zip(src1_data, src2_data)])
+        op = extras.expression_fc32_fc32("(1-2j)*in0 + in0/in1 - 1j", 2)
+        self.help_cc ((src1_data, src2_data), expected_result, op)
+
+    def test_expression_rejects (self):
+        self.assertRaises(ValueError, extras.expression_f32_f32, "in0 +", 1)
+        self.assertRaises(ValueError, extras.expression_f32_f32, "in1", 1)
+        self.assertRaises(ValueError, extras.expression_f32_f32, "1j*in0", 1)
+        self.assertRaises(ValueError, extras.expression_s16_s16, "0.5*in0 + 3", 1)
+        self.assertRaises(ValueError, extras.expression_sc16_sc16, "(1-0.5j)*in0", 1)
+
+    def test_expression_ss (self):
+        src1_data = [i - 500 for i in range(1000)]
+        src2_data = [i % 7 for i in range(1000)]
+        expected_result = tuple([3*a - (b - 1)*a + 7 for a, b in zip(src1_data, src2_data)])
+        src1 = gr.vector_source_s (src1_data)
+        src2 = gr.vector_source_s (src2_data)
+        op = extras.expression_s16_s16("3*in0 - (in1 - 1)*in0 + 7", 2)
+        dst = gr.vector_sink_s ()
+        self.tb.connect (src1, (op, 0))
+        self.tb.connect (src2, (op, 1))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_expression_sc16 (self):
+        #interleaved I and Q, (1-2j)*(a+bj) + 3j = (a+2b) + (b-2a+3)j
+        src_data = (1, 2, -3, 4, 100, -50)
+        expected_result = (5, 3, 5, 13, 0, -247)
+        src = gr.vector_source_s (src_data, False, 2)
+        op = extras.expression_sc16_sc16("(1-2j)*in0 + 3j", 1)
+        dst = gr.vector_sink_s (2)
+        self.tb.connect (src, op, dst)
+        self.tb.run ()
+        self.assertEqual (expected_result, dst.data ())
+
+    def test_mult_const_retune (self):
+        #every vector of the output uses one snapshot of the constant
+        src = gr.vector_source_f ([1.0]*200000, False, 2)
+        op = extras.multiply_const_v_f32_f32([0, 0])
+        dst = gr.vector_sink_f (2)
+        self.tb.connect (src, op, dst)
+        self.tb.start ()
+        for i in range (1000):
+            op.set_const([i, i])
+        self.tb.wait ()
+        self.assertEqual ([999, 999], [x.real for x in op.get_const()])
+        result_data = dst.data ()
+        self.assertEqual (result_data[0::2], result_data[1::2])
+
+    def test_inplace_chain_ff (self):
+        src_data = [float(i) for i in range(10000)]
+        expected_result = tuple([-(x+1)*2 for x in src_data])
+        add = extras.add_const_v_f32_f32([1])
+        mult = extras.multiply_const_v_f32_f32([2])
+        neg = extras.subtract_f32_f32(1)
+        op = extras.inplace_chain([s.to_basic_block() for s in (add, mult, neg)])
+        self.help_ff ((src_data,), expected_result, op)
+
+    def test_inplace_chain_rejects (self):
+        #subtract works in place, but two inputs cannot share one buffer
+        self.assertRaises(ValueError, extras.inplace_chain,
+            [extras.subtract_f32_f32(2).to_basic_block()])
+
+    def test_inplace_chain_rejects_not_inplace (self):
+        #add does not declare that it works in place
+        self.assertRaises(ValueError, extras.inplace_chain,
+            [extras.add_f32_f32(1).to_basic_block()])
+
 
 
 if __name__ == '__main__':
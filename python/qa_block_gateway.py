@@ -101,6 +101,22 @@ class interp2x(gr.block):
         output_items[0][::2] = input_items[0]
         return len(output_items[0])
 
+class resample3over7(gr.block):
+    def __init__(self):
+        gr.block.__init__(
+            self,
+            name = "resample 3/7",
+            in_sig = [numpy.float32],
+            out_sig = [numpy.float32],
+        )
+        self.set_rate(3, 7)
+
+    def work(self, input_items, output_items):
+        #every group of 7 inputs makes 3 outputs
+        index = (numpy.arange(len(output_items[0]))*7)/3
+        output_items[0][:] = input_items[0][index]
+        return len(output_items[0])
+
 class tag_source(gr.block):
     def __init__(self):
         gr.block.__init__(
@@ -149,6 +165,71 @@ class tag_sink(gr.block):
 
         return num_input_items
 
+class tag_every_source(gr.block):
+    def __init__(self, period):
+        gr.block.__init__(
+            self,
+            name = "tag every source",
+            in_sig = None,
+            out_sig = [numpy.float32],
+        )
+        self._period = period
+        self._keys = [pmt.pmt_string_to_symbol("even"), pmt.pmt_string_to_symbol("odd")]
+
+    def work(self, input_items, output_items):
+        #tag every period'th item, alternating between two keys
+        nwritten = self.nitems_written(0)
+        for offset in range(nwritten, nwritten + len(output_items[0])):
+            if offset % self._period: continue
+            n = offset/self._period
+            self.add_item_tag(0, offset, self._keys[n%2], pmt.pmt_from_long(n))
+        return len(output_items[0])
+
+class tag_chunk_sink(gr.block):
+    def __init__(self, chunk):
+        gr.block.__init__(
+            self,
+            name = "tag chunk sink",
+            in_sig = [numpy.float32],
+            out_sig = None,
+        )
+        self._chunk = chunk
+        self._keys = [pmt.pmt_string_to_symbol("even"), pmt.pmt_string_to_symbol("odd")]
+        self.mismatches = 0
+        self.count = 0
+
+    def work(self, input_items, output_items):
+        #many keyed queries per call, checked against one plain query
+        nread = self.nitems_read(0)
+        end = nread + len(input_items[0])
+        expected = [t.offset for t in self.get_tags_in_range(0, nread, end)]
+        found = list()
+        for start in range(nread, end, self._chunk):
+            stop = min(start + self._chunk, end)
+            even = [t.offset for t in self.get_tags_in_range(0, start, stop, self._keys[0])]
+            odd = [t.offset for t in self.get_tags_in_range(0, start, stop, self._keys[1])]
+            found.extend(sorted(even + odd))
+        if found != expected: self.mismatches += 1
+        self.count += len(found)
+        return len(input_items[0])
+
+class rate0_sink(gr.block):
+    def __init__(self):
+        gr.block.__init__(
+            self,
+            name = "rate 0 sink",
+            in_sig = [numpy.float32],
+            out_sig = None,
+        )
+        self.set_auto_consume(False)
+        self.set_relative_rate(0.0)
+        self.count = 0
+
+    def work(self, input_items, output_items):
+        self.count += len(input_items[0])
+        self.consume(0, len(input_items[0]))
+        return 0
+
 class fc32_to_f32_2(gr.block):
     def __init__(self):
         gr.block.__init__(
@@ -163,6 +244,21 @@ class fc32_to_f32_2(gr.block):
         output_items[0][::,1] = numpy.imag(input_items[0])
         return len(output_items[0])
 
+class work_size_recorder(gr.block):
+    def __init__(self):
+        gr.block.__init__(
+            self,
+            name = "work size recorder",
+            in_sig = [numpy.float32],
+            out_sig = [numpy.float32],
+        )
+        self.sizes = list()
+
+    def work(self, input_items, output_items):
+        self.sizes.append(len(output_items[0]))
+        output_items[0][:] = input_items[0]
+        return len(output_items[0])
+
 class test_block_gateway(gr_unittest.TestCase):
 
     def test_add_f32(self):
@@ -216,6 +312,17 @@ class test_block_gateway(gr_unittest.TestCase):
         tb.run()
         self.assertEqual(sink.data(), (1, 1, 3, 3, 5, 5, 7, 7, 9, 9))
 
+    def test_rational_rate(self):
+        data = range(7000)
+        tb = gr.top_block()
+        src = gr.vector_source_f(data, False)
+        resamp = resample3over7()
+        sink = gr.vector_sink_f()
+        tb.connect(src, resamp, sink)
+        tb.run()
+        self.assertEqual(resamp.output_multiple() % 3, 0)
+        self.assertEqual(sink.data(), tuple(float((k*7)/3) for k in range(3000)))
+
     def test_tags(self):
         src = tag_source()
         sink = tag_sink()
@@ -225,6 +332,25 @@ class test_block_gateway(gr_unittest.TestCase):
         tb.run()
         self.assertEqual(sink.key, "example_key")
 
+    def test_tag_index(self):
+        src = tag_every_source(10)
+        head = gr.head(gr.sizeof_float, 10000)
+        sink = tag_chunk_sink(25)
+        tb = gr.top_block()
+        tb.connect(src, head, sink)
+        tb.run()
+        self.assertEqual(sink.mismatches, 0)
+        self.assertEqual(sink.count, 1000)
+
+    def test_rate0(self):
+        tb = gr.top_block()
+        src = gr.vector_source_f(range(1000), False)
+        sink = rate0_sink()
+        self.assertEqual(sink.relative_rate(), 0.0)
+        tb.connect(src, sink)
+        tb.run()
+        self.assertEqual(sink.count, 1000)
+
     def test_fc32_to_f32_2(self):
         tb = gr.top_block()
         src = gr.vector_source_c([1+2j, 3+4j, 5+6j, 7+8j, 9+10j], False)
@@ -235,6 +361,56 @@ class test_block_gateway(gr_unittest.TestCase):
         tb.run()
         self.assertEqual(sink.data(), (1, 2, 3, 4, 5, 6, 7, 8, 9, 10))
 
+    def test_min_max_noutput_items(self):
+        data = range(10000)
+        tb = gr.top_block()
+        src = gr.vector_source_f(data, False)
+        rec_min = work_size_recorder()
+        rec_min.set_min_noutput_items(100)
+        rec_max = work_size_recorder()
+        rec_max.set_max_noutput_items(64)
+        sink = gr.vector_sink_f()
+        tb.connect(src, rec_min, rec_max, sink)
+        tb.run()
+        self.assertEqual(sink.data(), tuple(data))
+        self.assertTrue(min(rec_min.sizes) >= 100)
+        self.assertTrue(max(rec_max.sizes) <= 64)
+
+    def test_min_noutput_items_tail(self):
+        #the stream does not end on a multiple of the minimum
+        data = range(1050)
+        tb = gr.top_block()
+        src = gr.vector_source_f(data, False)
+        rec = work_size_recorder()
+        rec.set_min_noutput_items(100)
+        sink = gr.vector_sink_f()
+        tb.connect(src, rec, sink)
+        tb.run()
+        self.assertEqual(sink.data(), tuple(data))
+        self.assertTrue(min(rec.sizes[:-1]) >= 100)
+        self.assertEqual(sum(rec.sizes), 1050)
+
+    def test_max_below_min_noutput_items(self):
+        rec = work_size_recorder()
+        rec.set_min_noutput_items(100)
+        self.assertRaises(ValueError, rec.set_max_noutput_items, 64)
+        rec.set_min_noutput_items(0)
+        rec.set_max_noutput_items(64)
+        self.assertRaises(ValueError, rec.set_min_noutput_items, 100)
+
+    def test_thread_affinity(self):
+        data = range(1000)
+        tb = gr.top_block()
+        src = gr.vector_source_f(data, False)
+        rec = work_size_recorder()
+        rec.set_processor_affinity([0])
+        rec.set_thread_priority(0.0, False)
+        self.assertEqual(tuple(rec.processor_affinity()), (0,))
+        sink = gr.vector_sink_f()
+        tb.connect(src, rec, sink)
+        tb.run()
+        self.assertEqual(sink.data(), tuple(data))
+
 if __name__ == '__main__':
     gr_unittest.run(test_block_gateway, "test_block_gateway.xml")
 
@@ -26,6 +26,7 @@ except ImportError: from gruel import pmt
 
 from gnuradio import gr, gr_unittest
 import block_gateway #needed to inject into gr
+import extras_swig as extras
 
 class demo_msg_src(gr.block):
     def __init__(self, msgs):
@@ -72,6 +73,74 @@ class demo_msg_sink(gr.block):
             self._msgs.append(pmt.pmt_symbol_to_string(msg.value))
             if len(self._msgs) == self._num: return -1
 
+class demo_msg_batch_sink(gr.block):
+    def __init__(self, num):
+        gr.block.__init__(
+            self,
+            name = "demo msg batch sink",
+            in_sig = None,
+            out_sig = None,
+            num_msg_inputs = 1
+        )
+        self._msgs = []
+        self._num = num
+
+    def msgs(self): return self._msgs
+
+    def work(self, input_items, output_items):
+        while True:
+            for msg in self.pop_msg_queue_batch(16, 1.0):
+                self._msgs.append(pmt.pmt_symbol_to_string(msg.value))
+            if len(self._msgs) == self._num: return -1
+
+class demo_msg_mixed_src(gr.block):
+    def __init__(self, msgs):
+        gr.block.__init__(
+            self,
+            name = "demo msg mixed src",
+            in_sig = None,
+            out_sig = None,
+            num_msg_outputs = 1,
+        )
+        self._msgs = msgs #(msg, priority) pairs
+
+    def work(self, input_items, output_items):
+        key = pmt.pmt_string_to_symbol("example_key")
+        for msg, priority in self._msgs:
+            self.post_msg(0, key, pmt.pmt_string_to_symbol(msg), pmt.PMT_F, priority)
+        import time
+        time.sleep(.1)
+        return -1
+
+class demo_msg_queued_sink(gr.block):
+    def __init__(self, num_bulk, num):
+        gr.block.__init__(
+            self,
+            name = "demo msg queued sink",
+            in_sig = None,
+            out_sig = None,
+            num_msg_inputs = 1
+        )
+        self._msgs = []
+        self._num_bulk = num_bulk
+        self._num = num
+
+    def msgs(self): return self._msgs
+
+    def work(self, input_items, output_items):
+        #pop only once every bulk msg is queued, a control msg posted
+        #before the last bulk msg is in its lane by then too
+        import time
+        deadline = time.time() + 10.0
+        while self.perf_counters().msg_queue_high_water < self._num_bulk:
+            if time.time() > deadline: return -1
+            time.sleep(.01)
+        while len(self._msgs) < self._num:
+            msg = self.pop_msg_queue(timeout=1.0)
+            if msg is None: return -1
+            self._msgs.append(pmt.pmt_symbol_to_string(msg.value))
+        return -1
+
 class test_msg_passing(gr_unittest.TestCase):
 
     def test_top(self):
@@ -132,6 +201,176 @@ class test_msg_passing(gr_unittest.TestCase):
         tb.run()
         self.assertItemsEqual(sink.msgs(), msgs)
 
+    def test_order(self):
+        #enough msgs to span the switch over to the direct channel
+        msgs = tuple(str(i) for i in range(1000))
+        tb = gr.top_block()
+        src = demo_msg_src(msgs)
+        sink = demo_msg_sink(len(msgs))
+        tb.connect(src, sink)
+        tb.run()
+        self.assertEqual(tuple(sink.msgs()), msgs)
+
+    def test_fanout(self):
+        msgs = tuple(str(i) for i in range(100))
+        tb = gr.top_block()
+        src = demo_msg_src(msgs)
+        sink0 = demo_msg_sink(len(msgs))
+        sink1 = demo_msg_sink(len(msgs))
+        tb.connect(src, sink0)
+        tb.connect(src, sink1)
+        tb.run()
+        self.assertEqual(tuple(sink0.msgs()), msgs)
+        self.assertEqual(tuple(sink1.msgs()), msgs)
+
+    def test_batch(self):
+        msgs = tuple(str(i) for i in range(100))
+        tb = gr.top_block()
+        src = demo_msg_src(msgs)
+        sink = demo_msg_batch_sink(len(msgs))
+        tb.connect(src, sink)
+        tb.run()
+        self.assertEqual(tuple(sink.msgs()), msgs)
+
+    def test_many_to_one(self):
+        msgs0 = tuple("a%d"%i for i in range(50))
+        msgs1 = tuple("b%d"%i for i in range(50))
+        tb = gr.top_block()
+        src0 = demo_msg_src(msgs0)
+        src1 = demo_msg_src(msgs1)
+        m21 = extras.msg_many_to_one(2)
+        sink = demo_msg_sink(len(msgs0) + len(msgs1))
+        tb.connect(src0, (m21, 0))
+        tb.connect(src1, (m21, 1))
+        tb.connect(m21, sink)
+        tb.run()
+        #each input keeps its order, the inputs interleave
+        self.assertEqual(tuple(m for m in sink.msgs() if m[0] == 'a'), msgs0)
+        self.assertEqual(tuple(m for m in sink.msgs() if m[0] == 'b'), msgs1)
+
+    def test_many_to_one_priority(self):
+        bulk = extras.MSG_PRIORITY_BULK
+        msgs0 = tuple("a%d"%i for i in range(50))
+        msgs1 = tuple("b%d"%i for i in range(50))
+        tb = gr.top_block()
+        src0 = demo_msg_mixed_src([(m, bulk) for m in msgs0] +
+            [("retune", extras.MSG_PRIORITY_CONTROL), ("a_end", bulk)])
+        src1 = demo_msg_mixed_src([(m, bulk) for m in msgs1])
+        m21 = extras.msg_many_to_one(2)
+        sink = demo_msg_queued_sink(101, 102)
+        tb.connect(src0, (m21, 0))
+        tb.connect(src1, (m21, 1))
+        tb.connect(m21, sink)
+        tb.run()
+        #the control msg keeps its priority through the relay
+        self.assertEqual(len(sink.msgs()), 102)
+        self.assertEqual(sink.msgs()[0], "retune")
+        self.assertEqual(tuple(m for m in sink.msgs() if m[0] == 'a'), msgs0 + ("a_end",))
+        self.assertEqual(tuple(m for m in sink.msgs() if m[0] == 'b'), msgs1)
+
+    def test_timeout(self):
+        class demo_msg_timeout_sink(gr.block):
+            def __init__(self):
+                gr.block.__init__(self, name = "timeout sink",
+                    in_sig = None, out_sig = None, num_msg_inputs = 1)
+            def work(self, input_items, output_items):
+                self.timed_out = self.pop_msg_queue(timeout=0.01) is None
+                self.no_wait = not self.wait_msg_or_input(0.01)
+                return -1
+
+        tb = gr.top_block()
+        src = demo_msg_src(())
+        sink = demo_msg_timeout_sink()
+        tb.connect(src, sink)
+        tb.run()
+        self.assertTrue(sink.timed_out)
+        self.assertTrue(sink.no_wait)
+
+    def test_drop_oldest(self):
+        class demo_msg_slow_sink(gr.block):
+            def __init__(self):
+                gr.block.__init__(self, name = "slow sink",
+                    in_sig = None, out_sig = None, num_msg_inputs = 1)
+                self.set_msg_queue_capacity(0, 10, extras.MSG_OVERFLOW_DROP_OLDEST)
+                self.msgs = []
+            def work(self, input_items, output_items):
+                #pop once all 100 msgs are in: 10 queued, 90 dropped
+                import time
+                deadline = time.time() + 10.0
+                while self.msg_queue_dropped(0) < 90 and time.time() < deadline:
+                    time.sleep(.01)
+                while True:
+                    msg = self.pop_msg_queue(timeout=0.1)
+                    if msg is None: break
+                    self.msgs.append(pmt.pmt_symbol_to_string(msg.value))
+                self.dropped = self.msg_queue_dropped(0)
+                return -1
+
+        msgs = tuple(str(i) for i in range(100))
+        tb = gr.top_block()
+        src = demo_msg_src(msgs)
+        sink = demo_msg_slow_sink()
+        tb.connect(src, sink)
+        tb.run()
+        self.assertEqual(tuple(sink.msgs), msgs[-10:])
+        self.assertEqual(sink.dropped, 90)
+
+    def test_control_priority(self):
+        bulk = extras.MSG_PRIORITY_BULK
+        msgs = tuple(str(i) for i in range(100))
+        tb = gr.top_block()
+        src = demo_msg_mixed_src([(m, bulk) for m in msgs] +
+            [("retune", extras.MSG_PRIORITY_CONTROL), ("end", bulk)])
+        sink = demo_msg_queued_sink(101, 102)
+        tb.connect(src, sink)
+        tb.run()
+        #the control msg jumps the queue, the bulk msgs keep their order
+        self.assertEqual(tuple(sink.msgs()), ("retune",) + msgs + ("end",))
+
+    def test_perf_counters(self):
+        msgs = tuple(str(i) for i in range(10))
+        tb = gr.top_block()
+        src = demo_msg_src(msgs)
+        sink = demo_msg_sink(len(msgs))
+        tb.connect(src, sink)
+        tb.run()
+        src_perf = src.perf_counters()
+        sink_perf = sink.perf_counters()
+        self.assertEqual(src_perf.msgs_posted, len(msgs))
+        self.assertEqual(sink_perf.msgs_popped, len(msgs))
+        self.assertEqual(src_perf.work_calls, 1)
+        self.assertTrue(src_perf.work_time_total >= 0.1) #src sleeps in work
+        self.assertTrue(src_perf.work_time_max <= src_perf.work_time_total)
+        self.assertTrue(sink_perf.msg_queue_high_water >= 1)
+
+    def test_trace(self):
+        import json, os, tempfile
+        msgs = ("this", "test", "should", "pass")
+        tb = gr.top_block()
+        src = demo_msg_src(msgs)
+        sink = demo_msg_sink(len(msgs))
+        tb.connect(src, sink)
+        extras.block.set_tracing(True)
+        tb.run()
+        extras.block.set_tracing(False)
+        fd, path = tempfile.mkstemp(suffix='.json')
+        os.close(fd)
+        extras.block.write_trace(path)
+        events = json.load(open(path))['traceEvents']
+        os.remove(path)
+        cats = set(e['cat'] for e in events if e['args']['id'] == src.unique_id())
+        self.assertTrue('work' in cats)
+        self.assertTrue('post_msg' in cats)
+
+        #cleared events are not written again
+        extras.block.clear_trace()
+        fd, path = tempfile.mkstemp(suffix='.json')
+        os.close(fd)
+        extras.block.write_trace(path)
+        events = json.load(open(path))['traceEvents']
+        os.remove(path)
+        self.assertEqual(len(events), 0)
+
 if __name__ == '__main__':
     gr_unittest.run(test_msg_passing, "test_msg_passing.xml")
 
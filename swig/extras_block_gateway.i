@@ -60,4 +60,24 @@ gr_tag_t gr_block_gw_pop_msg_queue_safe(boost::shared_ptr<block_gateway> block_g
     return msg;
 }
 
+std::vector<gr_tag_t> gr_block_gw_pop_msg_queue_batch_safe(
+    boost::shared_ptr<block_gateway> block_gw, const size_t max, const double timeout
+){
+    std::vector<gr_tag_t> msgs;
+    GR_PYTHON_BLOCKING_CODE(
+        msgs = block_gw->gr_block__pop_msg_queue_batch(max, timeout);
+    )
+    return msgs;
+}
+
+bool gr_block_gw_wait_msg_or_input_safe(
+    boost::shared_ptr<block_gateway> block_gw, const double timeout
+){
+    bool ready = false;
+    GR_PYTHON_BLOCKING_CODE(
+        ready = block_gw->gr_block__wait_msg_or_input(timeout);
+    )
+    return ready;
+}
+
 %}
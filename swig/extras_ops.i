@@ -25,7 +25,10 @@
 %{
 #include <gnuradio/extras/add.h>
 #include <gnuradio/extras/add_const.h>
+#include <gnuradio/extras/convert.h>
 #include <gnuradio/extras/divide.h>
+#include <gnuradio/extras/expression.h>
+#include <gnuradio/extras/inplace_chain.h>
 #include <gnuradio/extras/multiply.h>
 #include <gnuradio/extras/multiply_const.h>
 #include <gnuradio/extras/subtract.h>
@@ -33,7 +36,10 @@
 
 %include <gnuradio/extras/add.h>
 %include <gnuradio/extras/add_const.h>
+%include <gnuradio/extras/convert.h>
 %include <gnuradio/extras/divide.h>
+%include <gnuradio/extras/expression.h>
+%include <gnuradio/extras/inplace_chain.h>
 %include <gnuradio/extras/multiply.h>
 %include <gnuradio/extras/multiply_const.h>
 %include <gnuradio/extras/subtract.h>
@@ -69,3 +75,25 @@ MAKE_ALL_THE_OP_TYPES(add_const)
 MAKE_ALL_THE_OP_TYPES(add_const_v)
 MAKE_ALL_THE_OP_TYPES(multiply_const)
 MAKE_ALL_THE_OP_TYPES(multiply_const_v)
+
+GR_EXTRAS_SWIG_BLOCK_FACTORY(inplace_chain)
+
+GR_EXTRAS_SWIG_BLOCK_FACTORY_DECL(expression)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(expression, fc32_fc32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(expression, sc16_sc16)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(expression, f32_f32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(expression, s16_s16)
+
+GR_EXTRAS_SWIG_BLOCK_FACTORY_DECL(convert)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, sc32_fc32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, sc16_fc32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, sc8_fc32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, fc32_sc32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, fc32_sc16)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, fc32_sc8)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, s32_f32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, s16_f32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, s8_f32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, f32_s32)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, f32_s16)
+GR_EXTRAS_SWIG_BLOCK_FACTORY2(convert, f32_s8)
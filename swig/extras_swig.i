@@ -32,10 +32,42 @@
 %include <gnuradio.i>
 %include "extras_factory.i"
 
+%template(uint64_vector_t) std::vector<uint64_t>;
+
 //use a dummy block class to save on swig generation size
 //%include <gnuradio/block.h>
+//%include <gnuradio/msg_block.h>
 namespace gnuradio {
-    class block : public gr_hier_block2{};
+    struct block_perf_counters
+    {
+        uint64_t work_calls;
+        double work_time_total;
+        double work_time_max;
+        std::vector<uint64_t> items_consumed;
+        std::vector<uint64_t> items_produced;
+        size_t msg_queue_high_water;
+        uint64_t msgs_posted;
+        uint64_t msgs_popped;
+    };
+
+    class block : public gr_hier_block2{
+    public:
+        block_perf_counters perf_counters(void);
+        static void set_tracing(const bool enable);
+        static void write_trace(const std::string &path);
+        static void clear_trace(void);
+        void set_processor_affinity(const std::vector<int> &cpus);
+        std::vector<int> processor_affinity(void) const;
+        void set_thread_priority(const double priority, const bool realtime = true);
+        void set_work_split(const size_t min_items);
+        size_t work_split(void) const;
+    };
+
+    class msg_block : public gr_hier_block2{
+    public:
+        void set_processor_affinity(const std::vector<int> &cpus);
+        void set_thread_priority(const double priority, const bool realtime = true);
+    };
 }
 
 namespace std {